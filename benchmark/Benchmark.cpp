@@ -0,0 +1,849 @@
+#include "World.h"
+#include "EntityManager.h"
+#include "SystemManager.h"
+#include "GroupManager.h"
+#include "SpawnBuffer.h"
+#include "Prefab.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+* Standalone benchmark suite for the core Atlas operations.
+*
+* Usage:
+~~~~~~~~~~~~~~~~~~
+* Atlas-ECS-Benchmark [--quick] [output.json]
+~~~~~~~~~~~~~~~~~~
+* Results are written as JSON to stdout, or to the given file. The layout is
+* versioned by FORMAT_VERSION; benchmark names and fields are only ever added,
+* never renamed, so numbers can be compared across releases.
+*/
+
+namespace
+{
+	/** Version of the JSON layout written by the suite */
+	const int FORMAT_VERSION = 1;
+
+	/** Number of times each benchmark is repeated. The fastest run is reported. */
+	const int REPETITIONS = 3;
+
+	/**
+	* Upper bound on operations for benchmarks whose per-operation cost grows with the
+	* number of entities (removals from Systems and groups). Keeps the 1M runs bounded.
+	*/
+	const unsigned int BATCH = 10000;
+
+	struct PositionComponent : public Atlas::Component
+	{
+		PositionComponent() : x(0.f), y(0.f) {}
+		float x, y;
+	};
+
+	struct VelocityComponent : public Atlas::Component
+	{
+		VelocityComponent() : x(1.f), y(1.f) {}
+		float x, y;
+	};
+
+	struct HealthComponent : public Atlas::Component
+	{
+		HealthComponent() : hitpoints(100.f), regeneration(0.5f) {}
+		float hitpoints, regeneration;
+	};
+
+	/** Iterates Entities with a single Component */
+	struct DriftSystem : public Atlas::System
+	{
+		DriftSystem(Atlas::World& world) : System(world)
+		{
+			addComponentType<PositionComponent>();
+		}
+
+		void update(float dt)
+		{
+			Atlas::EntityManager& eManager = getWorld().getEntityManager();
+
+			for (const Atlas::Entity::ID& id : getEntities())
+				eManager.getComponentFor<PositionComponent>(id)->x += dt;
+		}
+	};
+
+	/** Iterates Entities with two Components */
+	struct MovementSystem : public Atlas::System
+	{
+		MovementSystem(Atlas::World& world) : System(world)
+		{
+			addComponentType<PositionComponent>();
+			addComponentType<VelocityComponent>();
+		}
+
+		void update(float dt)
+		{
+			Atlas::EntityManager& eManager = getWorld().getEntityManager();
+
+			for (const Atlas::Entity::ID& id : getEntities())
+			{
+				PositionComponent* position = eManager.getComponentFor<PositionComponent>(id);
+				VelocityComponent* velocity = eManager.getComponentFor<VelocityComponent>(id);
+
+				position->x += velocity->x * dt;
+				position->y += velocity->y * dt;
+			}
+		}
+	};
+
+	/** MovementSystem through handles acquired in the constructor, to compare with iterate_2 */
+	struct HandleMovementSystem : public Atlas::System
+	{
+		HandleMovementSystem(Atlas::World& world) : System(world)
+		{
+			addComponentType<PositionComponent>();
+			addComponentType<VelocityComponent>();
+
+			Atlas::EntityManager& eManager = world.getEntityManager();
+			mPositions = eManager.getHandle<PositionComponent>();
+			mVelocities = eManager.getHandle<VelocityComponent>();
+		}
+
+		void update(float dt)
+		{
+			for (const Atlas::Entity::ID& id : getEntities())
+			{
+				PositionComponent* position = mPositions.get(id);
+				const VelocityComponent* velocity = mVelocities.read(id);
+
+				position->x += velocity->x * dt;
+				position->y += velocity->y * dt;
+			}
+		}
+
+		Atlas::EntityManager::Handle<PositionComponent> mPositions;
+		Atlas::EntityManager::Handle<VelocityComponent> mVelocities;
+	};
+
+	/** Iterates Entities with three Components */
+	struct RegenerationSystem : public Atlas::System
+	{
+		RegenerationSystem(Atlas::World& world) : System(world)
+		{
+			addComponentType<PositionComponent>();
+			addComponentType<VelocityComponent>();
+			addComponentType<HealthComponent>();
+		}
+
+		void update(float dt)
+		{
+			Atlas::EntityManager& eManager = getWorld().getEntityManager();
+
+			for (const Atlas::Entity::ID& id : getEntities())
+			{
+				PositionComponent* position = eManager.getComponentFor<PositionComponent>(id);
+				VelocityComponent* velocity = eManager.getComponentFor<VelocityComponent>(id);
+				HealthComponent* health = eManager.getComponentFor<HealthComponent>(id);
+
+				health->hitpoints += health->regeneration * dt;
+				position->x -= velocity->x * dt;
+			}
+		}
+	};
+
+	struct FieldPositionComponent : public Atlas::FieldComponent<float, 2>
+	{
+		enum Field { X, Y };
+	};
+
+	struct FieldVelocityComponent : public Atlas::FieldComponent<float, 2>
+	{
+		enum Field { X, Y };
+	};
+
+	/** MovementSystem over field arrays, the loops are simple enough for the compiler to vectorize */
+	struct FieldMovementSystem : public Atlas::System
+	{
+		FieldMovementSystem(Atlas::World& world) : System(world)
+		{
+			addComponentType<FieldPositionComponent>();
+			addComponentType<FieldVelocityComponent>();
+		}
+
+		void update(float dt)
+		{
+			Atlas::FieldManager& fManager = getWorld().getFieldManager();
+
+			for (std::size_t field = 0; field < 2; field++)
+			{
+				const Atlas::FieldSpan<float> position = fManager.getField<FieldPositionComponent>(field);
+				const Atlas::FieldSpan<float> velocity = fManager.getField<FieldVelocityComponent>(field);
+				float* x = position.data;
+				const float* vx = velocity.data;
+
+				for (std::size_t i = 0; i < position.size; i++)
+					x[i] += vx[i] * dt;
+			}
+		}
+	};
+
+	/** Measures wall time of a section in nanoseconds */
+	class Stopwatch
+	{
+	public:
+		Stopwatch() : mStart(std::chrono::steady_clock::now()) {}
+
+		double elapsed() const
+		{
+			return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - mStart).count();
+		}
+
+	private:
+		std::chrono::steady_clock::time_point mStart;
+	};
+
+	/** Outcome of a single timed run */
+	struct Sample
+	{
+		Sample() : operations(0), nanoseconds(0.0) {}
+		unsigned int operations;
+		double nanoseconds;
+	};
+
+	/** Reported figures for one benchmark at one entity count */
+	struct Result
+	{
+		std::string name;
+		unsigned int entities;
+		Sample sample;
+	};
+
+	typedef Sample(*Benchmark)(unsigned int entities);
+
+	/** Registers the three iteration Systems with a World */
+	void addSystems(Atlas::World& world)
+	{
+		Atlas::SystemManager& sManager = world.getSystemManager();
+		sManager.addSystem(Atlas::System::Ptr(new DriftSystem(world)));
+		sManager.addSystem(Atlas::System::Ptr(new MovementSystem(world)));
+		sManager.addSystem(Atlas::System::Ptr(new RegenerationSystem(world)));
+	}
+
+	/**
+	* Creates Entities owning the first componentCount of Position, Velocity and Health.
+	*/
+	void populate(Atlas::World& world, unsigned int entities, int componentCount)
+	{
+		for (unsigned int i = 0; i < entities; i++)
+		{
+			Atlas::Entity& entity = world.createEntity();
+
+			if (componentCount > 0)
+				entity.addComponent(Atlas::Component::Ptr(new PositionComponent()));
+			if (componentCount > 1)
+				entity.addComponent(Atlas::Component::Ptr(new VelocityComponent()));
+			if (componentCount > 2)
+				entity.addComponent(Atlas::Component::Ptr(new HealthComponent()));
+		}
+	}
+
+	Sample createEntity(unsigned int entities)
+	{
+		std::unique_ptr<Atlas::World> world(new Atlas::World());
+		Sample sample;
+
+		Stopwatch watch;
+		for (unsigned int i = 0; i < entities; i++)
+			world->createEntity();
+		sample.nanoseconds = watch.elapsed();
+
+		sample.operations = entities;
+		return sample;
+	}
+
+	Sample entityChurn(unsigned int entities)
+	{
+		std::unique_ptr<Atlas::World> world(new Atlas::World());
+		addSystems(*world);
+		populate(*world, entities, 2);
+
+		const unsigned int churn = std::min(entities, BATCH) / 10;
+		const int rounds = 10;
+		Sample sample;
+
+		// Destroy a spread of Entities, reap them and spawn replacements
+		Stopwatch watch;
+		for (int round = 0; round < rounds; round++)
+		{
+			const unsigned int stride = entities / churn;
+			for (unsigned int i = 0; i < churn; i++)
+				world->getEntity(i * stride + round % stride).setActive(false);
+
+			world->getEntityManager().update();
+
+			for (unsigned int i = 0; i < churn; i++)
+			{
+				Atlas::Entity& entity = world->createEntity();
+				entity.addComponent(Atlas::Component::Ptr(new PositionComponent()));
+				entity.addComponent(Atlas::Component::Ptr(new VelocityComponent()));
+			}
+		}
+		sample.nanoseconds = watch.elapsed();
+
+		sample.operations = churn * rounds * 2;
+		return sample;
+	}
+
+	Sample addComponent(unsigned int entities)
+	{
+		std::unique_ptr<Atlas::World> world(new Atlas::World());
+		addSystems(*world);
+		populate(*world, entities, 0);
+
+		Sample sample;
+
+		Stopwatch watch;
+		for (unsigned int i = 0; i < entities; i++)
+			world->getEntity(i).addComponent(Atlas::Component::Ptr(new PositionComponent()));
+		sample.nanoseconds = watch.elapsed();
+
+		sample.operations = entities;
+		return sample;
+	}
+
+	Sample removeComponent(unsigned int entities)
+	{
+		std::unique_ptr<Atlas::World> world(new Atlas::World());
+		addSystems(*world);
+		populate(*world, entities, 3);
+
+		const unsigned int removals = std::min(entities, BATCH);
+		const unsigned int stride = entities / removals;
+		Sample sample;
+
+		Stopwatch watch;
+		for (unsigned int i = 0; i < removals; i++)
+			world->getEntity(i * stride).removeComponent<HealthComponent>();
+		sample.nanoseconds = watch.elapsed();
+
+		sample.operations = removals;
+		return sample;
+	}
+
+	Sample checkInterest(unsigned int entities)
+	{
+		std::unique_ptr<Atlas::World> world(new Atlas::World());
+		addSystems(*world);
+		populate(*world, entities, 2);
+
+		Atlas::SystemManager& sManager = world->getSystemManager();
+		Sample sample;
+
+		Stopwatch watch;
+		for (unsigned int i = 0; i < entities; i++)
+			sManager.checkInterest(world->getEntity(i));
+		sample.nanoseconds = watch.elapsed();
+
+		sample.operations = entities;
+		return sample;
+	}
+
+	Sample getComponent(unsigned int entities)
+	{
+		std::unique_ptr<Atlas::World> world(new Atlas::World());
+		populate(*world, entities, 1);
+
+		Atlas::EntityManager& eManager = world->getEntityManager();
+		float sum = 0.f;
+		Sample sample;
+
+		Stopwatch watch;
+		for (unsigned int i = 0; i < entities; i++)
+			sum += eManager.getComponentFor<PositionComponent>(i)->x;
+		sample.nanoseconds = watch.elapsed();
+
+		// Keep the loop observable so it can not be optimized away
+		volatile float sink = sum;
+		(void)sink;
+
+		sample.operations = entities;
+		return sample;
+	}
+
+	/** A single global value, such as the game clock */
+	struct ClockResource
+	{
+		ClockResource() : elapsed(0.f) {}
+		float elapsed;
+	};
+
+	Sample getResource(unsigned int entities)
+	{
+		std::unique_ptr<Atlas::World> world(new Atlas::World());
+		world->getResourceManager().set(ClockResource());
+
+		Atlas::ResourceManager& rManager = world->getResourceManager();
+		float sum = 0.f;
+		Sample sample;
+
+		Stopwatch watch;
+		for (unsigned int i = 0; i < entities; i++)
+			sum += rManager.get<ClockResource>().elapsed;
+		sample.nanoseconds = watch.elapsed();
+
+		// Keep the loop observable so it can not be optimized away
+		volatile float sink = sum;
+		(void)sink;
+
+		sample.operations = entities;
+		return sample;
+	}
+
+	template <typename T>
+	/**
+	* Times repeated updates of a single System over Entities that own all
+	* of Position, Velocity and Health.
+	*/
+	Sample iterate(unsigned int entities)
+	{
+		std::unique_ptr<Atlas::World> world(new Atlas::World());
+		addSystems(*world);
+		populate(*world, entities, 3);
+
+		T* system = world->getSystemManager().getSystem<T>();
+		const int updates = 5;
+		Sample sample;
+
+		Stopwatch watch;
+		for (int i = 0; i < updates; i++)
+			system->update(1.f / 60.f);
+		sample.nanoseconds = watch.elapsed();
+
+		sample.operations = entities * updates;
+		return sample;
+	}
+
+	/**
+	* Times repeated updates of HandleMovementSystem, to compare with iterate_2.
+	*/
+	Sample iterateHandles(unsigned int entities)
+	{
+		std::unique_ptr<Atlas::World> world(new Atlas::World());
+		HandleMovementSystem* system = new HandleMovementSystem(*world);
+		world->getSystemManager().addSystem(Atlas::System::Ptr(system));
+		populate(*world, entities, 2);
+
+		const int updates = 5;
+		Sample sample;
+
+		Stopwatch watch;
+		for (int i = 0; i < updates; i++)
+			system->update(1.f / 60.f);
+		sample.nanoseconds = watch.elapsed();
+
+		sample.operations = entities * updates;
+		return sample;
+	}
+
+	/**
+	* Times repeated updates of FieldMovementSystem, to compare with iterate_2.
+	*/
+	Sample iterateFields(unsigned int entities)
+	{
+		std::unique_ptr<Atlas::World> world(new Atlas::World());
+		FieldMovementSystem* system = new FieldMovementSystem(*world);
+		world->getSystemManager().addSystem(Atlas::System::Ptr(system));
+
+		Atlas::FieldManager& fManager = world->getFieldManager();
+		for (unsigned int i = 0; i < entities; i++)
+		{
+			Atlas::Entity& entity = world->createEntity();
+			entity.addComponent(Atlas::Component::Ptr(new FieldPositionComponent()));
+			entity.addComponent(Atlas::Component::Ptr(new FieldVelocityComponent()));
+			fManager.get<FieldVelocityComponent>(entity.getID(), FieldVelocityComponent::X) = 1.f;
+			fManager.get<FieldVelocityComponent>(entity.getID(), FieldVelocityComponent::Y) = 1.f;
+		}
+
+		const int updates = 5;
+		Sample sample;
+
+		Stopwatch watch;
+		for (int i = 0; i < updates; i++)
+			system->update(1.f / 60.f);
+		sample.nanoseconds = watch.elapsed();
+
+		sample.operations = entities * updates;
+		return sample;
+	}
+
+	/**
+	* Times adding a System to a populated World, which fills its Entity list
+	* with a single sweep over the Component bits of every Entity.
+	*/
+	Sample addSystem(unsigned int entities)
+	{
+		std::unique_ptr<Atlas::World> world(new Atlas::World());
+		populate(*world, entities, 2);
+
+		Sample sample;
+
+		Stopwatch watch;
+		world->getSystemManager().addSystem(Atlas::System::Ptr(new MovementSystem(*world)));
+		sample.nanoseconds = watch.elapsed();
+
+		sample.operations = entities;
+		return sample;
+	}
+
+	/**
+	* Times worker threads creating Entities with two Components through one SpawnBuffer
+	* each, including the commit of every buffer on the main thread.
+	*/
+	Sample spawnParallel(unsigned int entities)
+	{
+		std::unique_ptr<Atlas::World> world(new Atlas::World());
+		addSystems(*world);
+
+		const unsigned int workers = std::max(1u, std::thread::hardware_concurrency());
+		std::vector<std::unique_ptr<Atlas::SpawnBuffer>> buffers;
+		for (unsigned int w = 0; w < workers; w++)
+			buffers.push_back(std::unique_ptr<Atlas::SpawnBuffer>(new Atlas::SpawnBuffer(world->getEntityManager())));
+
+		Sample sample;
+
+		Stopwatch watch;
+		std::vector<std::thread> threads;
+		for (unsigned int w = 0; w < workers; w++)
+		{
+			threads.push_back(std::thread([&buffers, w, workers, entities]()
+			{
+				Atlas::SpawnBuffer& buffer = *buffers[w];
+
+				for (unsigned int i = w; i < entities; i += workers)
+				{
+					const Atlas::Entity::ID id = buffer.createEntity();
+					buffer.addComponent(id, Atlas::Component::Ptr(new PositionComponent()));
+					buffer.addComponent(id, Atlas::Component::Ptr(new VelocityComponent()));
+				}
+			}));
+		}
+
+		for (auto& thread : threads)
+			thread.join();
+
+		for (auto& buffer : buffers)
+			world->getEntityManager().commit(*buffer);
+		sample.nanoseconds = watch.elapsed();
+
+		sample.operations = entities;
+		return sample;
+	}
+
+	/**
+	* Times creating Entities with Position, Velocity and Health from a Prefab,
+	* to compare with populating the same Entities one Component at a time.
+	*/
+	Sample instantiate(unsigned int entities)
+	{
+		std::unique_ptr<Atlas::World> world(new Atlas::World());
+		addSystems(*world);
+
+		Atlas::Prefab prefab;
+		prefab.addComponent(PositionComponent()).addComponent(VelocityComponent()).addComponent(HealthComponent());
+
+		Sample sample;
+
+		Stopwatch watch;
+		world->getEntityManager().instantiate(prefab, entities);
+		sample.nanoseconds = watch.elapsed();
+
+		sample.operations = entities;
+		return sample;
+	}
+
+	/**
+	* Times creating Entities with Position, Velocity and Health through addComponent().
+	*/
+	Sample populateSystems(unsigned int entities)
+	{
+		std::unique_ptr<Atlas::World> world(new Atlas::World());
+		addSystems(*world);
+
+		Sample sample;
+
+		Stopwatch watch;
+		populate(*world, entities, 3);
+		sample.nanoseconds = watch.elapsed();
+
+		sample.operations = entities;
+		return sample;
+	}
+
+	/**
+	* Times adding and removing an observed Component, with both events dispatched in one batch each.
+	*/
+	Sample observe(unsigned int entities)
+	{
+		std::unique_ptr<Atlas::World> world(new Atlas::World());
+		populate(*world, entities, 0);
+
+		Atlas::ObserverManager& oManager = world->getObserverManager();
+		std::size_t observed = 0;
+
+		oManager.onConstruct<HealthComponent>([&observed](const Atlas::ObserverBatch<HealthComponent>& batch)
+		{
+			observed += batch.size();
+		});
+
+		oManager.onDestroy<HealthComponent>([&observed](const Atlas::ObserverBatch<HealthComponent>& batch)
+		{
+			observed += batch.size();
+		});
+
+		Sample sample;
+
+		Stopwatch watch;
+		for (unsigned int i = 0; i < entities; i++)
+			world->getEntity(i).addComponent(Atlas::Component::Ptr(new HealthComponent()));
+		oManager.dispatch();
+
+		for (unsigned int i = 0; i < entities; i++)
+			world->getEntity(i).removeComponent<HealthComponent>();
+		oManager.dispatch();
+		sample.nanoseconds = watch.elapsed();
+
+		sample.operations = static_cast<unsigned int>(observed);
+		return sample;
+	}
+
+	Sample groupAdd(unsigned int entities)
+	{
+		std::unique_ptr<Atlas::World> world(new Atlas::World());
+		populate(*world, entities, 0);
+
+		Atlas::GroupManager& gManager = world->getGroupManager();
+		const char* names[] = { "Enemies", "Allies", "Bullets", "Pickups" };
+		Sample sample;
+
+		Stopwatch watch;
+		for (unsigned int i = 0; i < entities; i++)
+			gManager.addToGroup(names[i % 4], world->getEntity(i));
+		sample.nanoseconds = watch.elapsed();
+
+		sample.operations = entities;
+		return sample;
+	}
+
+	Sample groupGet(unsigned int entities)
+	{
+		std::unique_ptr<Atlas::World> world(new Atlas::World());
+		populate(*world, entities, 0);
+
+		Atlas::GroupManager& gManager = world->getGroupManager();
+		const char* names[] = { "Enemies", "Allies", "Bullets", "Pickups" };
+
+		for (unsigned int i = 0; i < entities; i++)
+			gManager.addToGroup(names[i % 4], world->getEntity(i));
+
+		std::size_t total = 0;
+		Sample sample;
+
+		Stopwatch watch;
+		for (int i = 0; i < 4; i++)
+			total += gManager.getGroup(names[i]).size();
+		sample.nanoseconds = watch.elapsed();
+
+		volatile std::size_t sink = total;
+		(void)sink;
+
+		sample.operations = entities;
+		return sample;
+	}
+
+	Sample groupRemove(unsigned int entities)
+	{
+		std::unique_ptr<Atlas::World> world(new Atlas::World());
+		populate(*world, entities, 0);
+
+		Atlas::GroupManager& gManager = world->getGroupManager();
+		const char* names[] = { "Enemies", "Allies", "Bullets", "Pickups" };
+
+		for (unsigned int i = 0; i < entities; i++)
+			gManager.addToGroup(names[i % 4], world->getEntity(i));
+
+		const unsigned int removals = std::min(entities, BATCH);
+		const unsigned int stride = entities / removals;
+		Sample sample;
+
+		Stopwatch watch;
+		for (unsigned int i = 0; i < removals; i++)
+			gManager.removeFromAllGroups(world->getEntity(i * stride));
+		sample.nanoseconds = watch.elapsed();
+
+		sample.operations = removals;
+		return sample;
+	}
+
+	Sample worldUpdate(unsigned int entities)
+	{
+		std::unique_ptr<Atlas::World> world(new Atlas::World());
+		addSystems(*world);
+		populate(*world, entities, 3);
+
+		const int updates = 5;
+		Sample sample;
+
+		Stopwatch watch;
+		for (int i = 0; i < updates; i++)
+			world->update(1.f / 60.f);
+		sample.nanoseconds = watch.elapsed();
+
+		sample.operations = entities * updates;
+		return sample;
+	}
+
+	/** Clones a populated World into a World with the same Systems, as done for prediction */
+	Sample cloneWorld(unsigned int entities, bool copyOnWrite)
+	{
+		std::unique_ptr<Atlas::World> world(new Atlas::World());
+		std::unique_ptr<Atlas::World> fork(new Atlas::World());
+		addSystems(*world);
+		addSystems(*fork);
+		populate(*world, entities, 3);
+
+		const int clones = 5;
+		Sample sample;
+
+		Stopwatch watch;
+		for (int i = 0; i < clones; i++)
+			world->clone(*fork, copyOnWrite);
+		sample.nanoseconds = watch.elapsed();
+
+		sample.operations = entities * clones;
+		return sample;
+	}
+
+	Sample worldClone(unsigned int entities)
+	{
+		return cloneWorld(entities, false);
+	}
+
+	Sample worldFork(unsigned int entities)
+	{
+		return cloneWorld(entities, true);
+	}
+
+	/** Runs a benchmark REPETITIONS times and keeps the fastest run */
+	Result run(const std::string& name, Benchmark benchmark, unsigned int entities)
+	{
+		Result result;
+		result.name = name;
+		result.entities = entities;
+
+		for (int i = 0; i < REPETITIONS; i++)
+		{
+			const Sample sample = benchmark(entities);
+
+			if (i == 0 || sample.nanoseconds < result.sample.nanoseconds)
+				result.sample = sample;
+		}
+
+		std::cerr << name << " (" << entities << "): "
+			<< result.sample.nanoseconds / result.sample.operations << " ns/op" << std::endl;
+
+		return result;
+	}
+
+	/** Writes results using the versioned JSON layout */
+	void writeJson(std::ostream& out, const std::vector<Result>& results)
+	{
+		out << "{\n"
+			<< "\t\"format\": \"atlas-benchmark\",\n"
+			<< "\t\"version\": " << FORMAT_VERSION << ",\n"
+			<< "\t\"results\": [\n";
+
+		for (std::size_t i = 0; i < results.size(); i++)
+		{
+			const Result& result = results[i];
+			std::ostringstream perOp;
+			perOp.precision(3);
+			perOp << std::fixed << result.sample.nanoseconds / result.sample.operations;
+
+			out << "\t\t{ \"name\": \"" << result.name << "\""
+				<< ", \"entities\": " << result.entities
+				<< ", \"operations\": " << result.sample.operations
+				<< ", \"total_ns\": " << (unsigned long long)result.sample.nanoseconds
+				<< ", \"ns_per_op\": " << perOp.str()
+				<< " }" << (i + 1 < results.size() ? "," : "") << "\n";
+		}
+
+		out << "\t]\n}" << std::endl;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	bool quick = false;
+	std::string outputPath;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--quick") == 0)
+			quick = true;
+		else
+			outputPath = argv[i];
+	}
+
+	std::vector<unsigned int> sizes;
+	sizes.push_back(10000);
+	sizes.push_back(100000);
+	if (!quick)
+		sizes.push_back(1000000);
+
+	std::vector<Result> results;
+
+	for (const auto& entities : sizes)
+	{
+		results.push_back(run("create_entity", createEntity, entities));
+		results.push_back(run("entity_churn", entityChurn, entities));
+		results.push_back(run("add_component", addComponent, entities));
+		results.push_back(run("remove_component", removeComponent, entities));
+		results.push_back(run("check_interest", checkInterest, entities));
+		results.push_back(run("get_component", getComponent, entities));
+		results.push_back(run("get_resource", getResource, entities));
+		results.push_back(run("iterate_1", iterate<DriftSystem>, entities));
+		results.push_back(run("iterate_2", iterate<MovementSystem>, entities));
+		results.push_back(run("iterate_3", iterate<RegenerationSystem>, entities));
+		results.push_back(run("iterate_handles", iterateHandles, entities));
+		results.push_back(run("iterate_fields", iterateFields, entities));
+		results.push_back(run("add_system", addSystem, entities));
+		results.push_back(run("spawn_parallel", spawnParallel, entities));
+		results.push_back(run("populate", populateSystems, entities));
+		results.push_back(run("instantiate", instantiate, entities));
+		results.push_back(run("observe", observe, entities));
+		results.push_back(run("group_add", groupAdd, entities));
+		results.push_back(run("group_get", groupGet, entities));
+		results.push_back(run("group_remove", groupRemove, entities));
+		results.push_back(run("world_update", worldUpdate, entities));
+		results.push_back(run("world_clone", worldClone, entities));
+		results.push_back(run("world_clone_cow", worldFork, entities));
+	}
+
+	if (outputPath.empty())
+	{
+		writeJson(std::cout, results);
+	}
+	else
+	{
+		std::ofstream file(outputPath.c_str());
+		writeJson(file, results);
+	}
+
+	return 0;
+}
@@ -1,10 +1,14 @@
 #pragma once
 #include "Bitsize.h"
 
+#include <atomic>
+#include <cstddef>
 #include <memory>
 
 namespace Atlas
 {
+	class Component;
+
 	/**
 	* Handle used for Components.
 	* Distributes a unique ID and Bitset for Components.
@@ -17,6 +21,9 @@ namespace Atlas
 		/** Standard pointer used for ComponentIdentifier */
 		typedef std::unique_ptr<ComponentIdentifier> Ptr;
 
+		/** Creates a copy of a Component of the identified type */
+		typedef Component*(*CopyFunction)(const Component& component);
+
 		/**
 		* Retrieves the unique ID for the identifier
 		*/
@@ -27,16 +34,38 @@ namespace Atlas
 		*/
 		std::bitset<BITSIZE> getBit() const;
 
+		/**
+		* Retrieves the name of the Component type, as given by typeid
+		*/
+		const char* getName() const;
+
+		/**
+		* Retrieves the size in bytes of the Component type.
+		* The size is 0 until the type is used through a templated ComponentIdentifierManager function.
+		*/
+		std::size_t getSize() const;
+
+		/**
+		* Retrieves the function that copies Components of the type.
+		* The function is nullptr until the type is used through a templated ComponentIdentifierManager
+		* function, and stays nullptr if the type is not copy constructible.
+		*/
+		CopyFunction getCopyFunction() const;
+
 	private:
 		friend class ComponentIdentifierManager;	// Give full access to the Manager
 
-		ComponentIdentifier();	// Only to be created by the manager
+		ComponentIdentifier(const char* name);	// Only to be created by the manager
 
 	private:
+		// only changed while the ComponentIdentifierManager registry is locked
 		static unsigned int             nextID;
 		static std::bitset<BITSIZE>     nextBit;
 
 		unsigned int                    mID;
 		std::bitset<BITSIZE>            mBit;
+		const char*                     mName;
+		std::atomic<std::size_t>        mSize;
+		std::atomic<CopyFunction>       mCopy;
 	};
 }
\ No newline at end of file
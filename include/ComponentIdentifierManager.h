@@ -1,17 +1,23 @@
 #pragma once
 #include "Bitsize.h"
+#include "ComponentIdentifier.h"
+#include "TypeRegistry.h"
 
-#include <unordered_map>
+#include <atomic>
 #include <typeindex>
+#include <type_traits>
 #include <memory>
+#include <vector>
 
 namespace Atlas
 {
-	class ComponentIdentifier;
-
 	/**
 	* Used to assign a unique ID and Bit to a System when
 	* added to the SystemManager.
+	*
+	* The registry is shared by every World and is safe to use from several threads.
+	* Lookups do not lock. Register every Component type at startup, then call freeze()
+	* so Worlds can run on separate threads without touching shared mutable state.
 	*/
 	class ComponentIdentifierManager
 	{
@@ -29,6 +35,40 @@ namespace Atlas
 		*/
 		static ComponentIdentifier& getType(const std::type_index& index);
 
+		/**
+		* Retrieves an identifier for a Component and records the size of the Component type.
+		* If an identifier has not been assigned to the Component, one is created and assigned.
+		* @param index - type_index for the Component
+		* @param size - sizeof the Component type
+		*/
+		static ComponentIdentifier& getType(const std::type_index& index, std::size_t size);
+
+		/**
+		* Retrieves an identifier for a Component and records the size and copy function of the Component type.
+		* If an identifier has not been assigned to the Component, one is created and assigned.
+		* @param index - type_index for the Component
+		* @param size - sizeof the Component type
+		* @param copy - copies a Component of the type, or nullptr if it can not be copied
+		*/
+		static ComponentIdentifier& getType(const std::type_index& index, std::size_t size, ComponentIdentifier::CopyFunction copy);
+
+		/**
+		* Retrieves every identifier that has been assigned.
+		* @return Container of ComponentIdentifiers, in no particular order
+		*/
+		static std::vector<const ComponentIdentifier*> getAllTypes();
+
+		/**
+		* Stops any further Component types from being registered.
+		* Registering a new type afterwards is an error.
+		*/
+		static void freeze();
+
+		/**
+		* Checks if the registry has been frozen.
+		*/
+		static bool isFrozen();
+
 		template <typename T>
 		/**
 		* Retrieves an identifier for a Component.
@@ -41,7 +81,17 @@ namespace Atlas
 		*/
 		static ComponentIdentifier& getType()
 		{
-			return getType(typeid(T));
+			// registered once per type, later calls read the cached identifier. Threads that race
+			// on the first call find the same identifier in the registry and store the same pointer
+			ComponentIdentifier* identifier = Cache<T>::identifier.load(std::memory_order_acquire);
+
+			if (identifier == nullptr)
+			{
+				identifier = &getType(typeid(T), sizeof(T), getCopyFunction<T>());
+				Cache<T>::identifier.store(identifier, std::memory_order_release);
+			}
+
+			return *identifier;
 		}
 
 		template <typename T>
@@ -55,7 +105,7 @@ namespace Atlas
 		*/
 		static std::bitset<BITSIZE> getBits()
 		{
-			return getType(typeid(T)).getBit();
+			return getType<T>().getBit();
 		}
 
 		template <typename T>
@@ -69,13 +119,44 @@ namespace Atlas
 		*/
 		static unsigned int getID()
 		{
-			return getType(typeid(T)).getID();
+			return getType<T>().getID();
 		}
 
 	private:
 		ComponentIdentifierManager() = default;	// Not meant for instantiation
 
-		static std::unordered_map < std::type_index,
-			std::unique_ptr < ComponentIdentifier >> ComponentMap;	// Map of Components-to-ComponentIdentifiers
+		template <typename T>
+		/**
+		* Identifier of a Component type once it has been looked up. Zero initialized before any
+		* code runs, unlike a function-local static, which VS2013 does not initialize thread-safely.
+		*/
+		struct Cache
+		{
+			static std::atomic<ComponentIdentifier*> identifier;
+		};
+
+		template <typename T>
+		static Component* copyComponent(const Component& component)
+		{
+			return new T(static_cast<const T&>(component));
+		}
+
+		template <typename T>
+		static typename std::enable_if<std::is_copy_constructible<T>::value, ComponentIdentifier::CopyFunction>::type getCopyFunction()
+		{
+			return &copyComponent<T>;
+		}
+
+		template <typename T>
+		static typename std::enable_if<!std::is_copy_constructible<T>::value, ComponentIdentifier::CopyFunction>::type getCopyFunction()
+		{
+			return nullptr;
+		}
+
+		/** Map of Components-to-ComponentIdentifiers */
+		static TypeRegistry<ComponentIdentifier::Ptr>& getRegistry();
 	};
+
+	template <typename T>
+	std::atomic<ComponentIdentifier*> ComponentIdentifierManager::Cache<T>::identifier;
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 #include <vector>
 #include <memory>
+#include <utility>
 
 namespace Atlas
 {
@@ -24,6 +25,9 @@ namespace Atlas
 		/** Standard pointer used an Entity */
 		typedef std::unique_ptr<Entity> Ptr;
 
+		/** Old and new ID of an Entity that was moved by EntityManager::defragment() */
+		typedef std::pair<ID, ID> Relocation;
+
 		template <typename Type>
 		/**
 		* Retrieves a specified Component from the Entity.
@@ -40,6 +44,17 @@ namespace Atlas
 			return mEntityManager.getComponentFor<Type>(*this);
 		}
 
+		template <typename Type>
+		/**
+		* Retrieves a specified Component from the Entity for reading only.
+		* Unlike getComponent(), this never copies a Component table that is shared with a clone.
+		* @return Component casted to it's derived type
+		*/
+		const Type* readComponent() const
+		{
+			return mEntityManager.readComponentFor<Type>(mID);
+		}
+
 		/**
 		* Retrieves all Components that are attached to the Entity.
 		* @return All Components owned by the Entity
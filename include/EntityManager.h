@@ -1,15 +1,20 @@
 #pragma once
-#include <stack>
 #include <vector>
 #include <memory>
 #include <cassert>
+#include <cstdint>
+#include <atomic>
 
 #include "Entity.h"
 #include "ComponentIdentifier.h"
+#include "MemoryReport.h"
 
 namespace Atlas
 {
 	class World;
+	class SpawnBuffer;
+	class Prefab;
+	struct Signature;
 
 	/**
 	* Manages all Entities and Components within the a World.
@@ -19,6 +24,97 @@ namespace Atlas
 	class EntityManager : public NonCopyable
 	{
 	public:
+		template <typename T>
+		/**
+		* Direct access to the Components of a single type, acquired once through getHandle<>().
+		* The type is resolved when the handle is acquired and the handle points straight at
+		* the table of the type, so each access is a single index into the table.
+		*
+		* Usage Example: (in MovementSystem)
+		~~~~~~~~~~~~~~~~~~
+		* mPositions = world.getEntityManager().getHandle<PositionComponent>();
+		*
+		* for (const Atlas::Entity::ID& id : getEntities())
+		*	mPositions.get(id)->x += dt;
+		~~~~~~~~~~~~~~~~~~
+		*/
+		class Handle
+		{
+		public:
+			/** Creates a handle that refers to no table, to be assigned later */
+			Handle()
+				: mEntityManager(nullptr)
+				, mTable(nullptr)
+				, mType(0)
+			{
+			}
+
+			/**
+			* Retrieves the Component of an Entity, to be written to.
+			* @param id - ID of the Entity, which must own the Component
+			*/
+			T* get(Entity::ID id) const
+			{
+				assert(mTable != nullptr);
+
+				// copy on write, the table is shared with a clone
+				if (mTable->use_count() > 1)
+					mEntityManager->getTable(mType);
+
+				assert(id < (*mTable)->size());
+				return cast((**mTable)[id].get());
+			}
+
+			/**
+			* Retrieves the Component of an Entity for reading only, never copying a shared table.
+			* @param id - ID of the Entity, which must own the Component
+			*/
+			const T* read(Entity::ID id) const
+			{
+				assert(mTable != nullptr);
+				assert(id < (*mTable)->size());
+				return cast((**mTable)[id].get());
+			}
+
+			/**
+			* Checks if an Entity owns the Component.
+			* @param id - ID of the Entity of interest
+			*/
+			bool has(Entity::ID id) const
+			{
+				assert(mTable != nullptr);
+
+				const std::vector<Component::Ptr>& table = **mTable;
+				return id < table.size() && table[id] != nullptr;
+			}
+
+		private:
+			friend class EntityManager;  // Acquires handles
+
+			Handle(EntityManager& eManager, unsigned int type)
+				: mEntityManager(&eManager)
+				, mTable(&eManager.mComponentsByType[type])
+				, mType(type)
+			{
+			}
+
+			static T* cast(Component* component)
+			{
+				// make sure the compnonent is there and a cast is safe
+				assert(component != nullptr);
+				assert(dynamic_cast<T*>(component) != nullptr);
+
+				return static_cast<T*>(component);
+			}
+
+		private:
+			EntityManager*                                      mEntityManager;
+
+			/** The entry of the type in mComponentsByType, which never moves */
+			std::shared_ptr<std::vector<Component::Ptr>>*       mTable;
+			unsigned int                                        mType;
+		};
+
 		/**
 		* Creates a new EntityManager.
 		* @param world - the World object that owns this EntityManager
@@ -36,6 +132,24 @@ namespace Atlas
 		*/
 		Entity& createEntity();
 
+		/**
+		* Creates Entities that own a copy of every Component of a Prefab.
+		* Each Query is tested once for the whole batch and the Entities are added to the
+		* matching Systems directly.
+		* @param prefab - the Prefab to be copied
+		* @param count - the number of Entities to create
+		* @return IDs of the new Entities
+		*/
+		std::vector<Entity::ID> instantiate(const Prefab& prefab, std::size_t count);
+
+		/**
+		* Adds the Entities and Components of a SpawnBuffer filled by a worker thread, and
+		* empties the buffer. Each Component type is merged into its table in one pass.
+		* Call on the main thread once the worker is done with the buffer.
+		* @param buffer - the SpawnBuffer to be committed
+		*/
+		void commit(SpawnBuffer& buffer);
+
 		/**
 		* Retreives an active Entity
 		* @param ID - The Entity's ID
@@ -93,9 +207,10 @@ namespace Atlas
 		*/
 		T* getComponentFor(const Entity::ID& ID) const
 		{
-			// grab the component from the vector
+			// grab the component from the vector, the table is copied if it is shared with a clone
+			// as the Component may be written to
 			const auto& componentID = ComponentIdentifierManager::getID<T>();
-			Component* component = mComponentsByType[componentID][ID].get();
+			Component* component = getTable(componentID)[ID].get();
 
 			// make sure the compnonent is there and a cast is safe
 			assert(component != nullptr);
@@ -104,8 +219,43 @@ namespace Atlas
 			return static_cast<T*>(component);
 		}
 
+		template <typename T>
 		/**
-		* Retrieves all the Components attached to an Entity.
+		* Acquires a handle to the Components of a type, for Systems that access them often.
+		* Handles stay valid for the life of the EntityManager.
+		* @return Handle to the Component table of the type
+		*/
+		Handle<T> getHandle()
+		{
+			return Handle<T>(*this, ComponentIdentifierManager::getID<T>());
+		}
+
+		template <typename T>
+		/**
+		* Retrieve a specific Component from an Entity for reading only.
+		* Unlike getComponentFor(), this never copies a Component table that is shared with a clone.
+		*
+		* Usage Example:
+		~~~~~~~~~~~~~~~~~~
+		* const TerrainComponent* terrain = entityManager.readComponentFor<TerrainComponent>(ID);
+		~~~~~~~~~~~~~~~~~~
+		* @param ID - The targeted Entity's ID
+		* @return Pointer to the derived type Component
+		*/
+		const T* readComponentFor(const Entity::ID& ID) const
+		{
+			const auto& componentID = ComponentIdentifierManager::getID<T>();
+			const Component* component = readTable(componentID)[ID].get();
+
+			assert(component != nullptr);
+			assert(dynamic_cast<const T*>(component) != nullptr);
+
+			return static_cast<const T*>(component);
+		}
+
+		/**
+		* Retrieves all the Components attached to an Entity, for reading.
+		* Never copies a Component table that is shared with a clone.
 		* @param entity - The targeted Entity
 		* @return Vector of Component pointers from the Entity
 		*/
@@ -117,35 +267,188 @@ namespace Atlas
 		*/
 		void removeAllComponentsFor(Entity& entity);
 
+		/**
+		* Destroys every Entity and Component immediately.
+		*/
+		void clear();
+
+		/**
+		* Adds the memory held for Entities and Components to a report.
+		* @param report - the report to be filled
+		*/
+		void reportMemory(MemoryReport& report) const;
+
+		/**
+		* Releases unused capacity held for Entities and Components.
+		* Tables are trimmed to the highest active Entity::ID and dead Entities
+		* above it are destroyed, so their IDs will be handed out again.
+		* Does nothing while a SpawnBuffer holds uncommitted Entities.
+		*/
+		void shrinkToFit();
+
+		/**
+		* Moves active Entities from the highest IDs into the lowest free IDs, so Entities
+		* and Components are packed at the front of each table. At most maxMoves Entities
+		* are moved per call, which allows the work to be spread across frames.
+		* Systems and groups are updated with the new IDs. Entity references stay valid,
+		* but any Entity::IDs held outside the World must be updated from the returned list.
+		* @param maxMoves - the maximum number of Entities to move
+		* @return The Entities that were moved. Empty once the tables are fully packed.
+		*/
+		std::vector<Entity::Relocation> defragment(unsigned int maxMoves);
+
+		/**
+		* Replaces the Entities, Components and groups of another World with copies of this one.
+		* Systems and Queries of the other World are kept; each Query takes the Entity list of the
+		* Query with the same Signature here, or checks every Entity if there is no match.
+		*
+		* With copyOnWrite, Component tables are shared instead of copied. A World copies a shared
+		* table the first time it writes to it, through getComponentFor(), a Handle, adding or
+		* removing a Component, or destroying an Entity. Tables that are only read, through
+		* readComponentFor() or getAllComponentsFor(), are never copied.
+		* Component pointers retrieved before the clone must not be written to afterwards.
+		*
+		* Every Component type in use must be copy constructible and have been used through a
+		* templated function such as getComponentFor<>() or System::addComponentType<>().
+		* @param target - the EntityManager of the other World
+		* @param copyOnWrite - share Component tables until they are written to
+		*/
+		void cloneTo(EntityManager& target, bool copyOnWrite) const;
+
+		/**
+		* Finds every active Entity that matches a Signature, in a single sweep over the
+		* packed Component bits of all Entities rather than visiting each Entity.
+		* Two Entities are tested per SSE2 AND and compare where SSE2 is available.
+		* @param signature - the Entities to be found
+		* @param matches - receives the Entity::IDs, in ascending order
+		*/
+		void findMatching(const Signature& signature, std::vector<Entity::ID>& matches) const;
+
 		/**
 		* Prints the contents of all active Entities and displays the number of inactive Entities
 		*/
 		void toString();
 
 	private:
+		friend class Snapshot;       // Restores Entities and Components directly
+		friend class SnapshotDelta;  // Patches Entities and Components directly
+		friend class QueryManager;   // Fills new queries from the active Entities
+		friend class SpawnBuffer;    // Reserves IDs from worker threads
+		friend class ObserverManager;  // Checks constructed Components are still owned
+
+		/** Components of a single type, indexed by Entity::ID */
+		typedef std::vector<Component::Ptr> ComponentTable;
+
+		/**
+		* Retrieves the Component table for a type, to be written to.
+		* If the table is shared with a clone, it is copied first. Const so getComponentFor(),
+		* which hands out writable Components, can be called on a const EntityManager.
+		* @param type - ComponentIdentifier ID of the type
+		*/
+		ComponentTable& getTable(unsigned int type) const;
+
+		/**
+		* Retrieves the Component table for a type, to be read from.
+		* @param type - ComponentIdentifier ID of the type
+		*/
+		const ComponentTable& readTable(unsigned int type) const;
+
 		/**
 		* Resets an Entity and moves it from the active Entity container to the dead Entity pool
 		* @param entity - The targeted Entity
 		*/
 		void removeEntity(Entity& entity);
 
+		/**
+		* Removes the dead Entity with the lowest ID from the pool
+		* @return the dead Entity
+		*/
+		Entity::Ptr takeLowestDeadEntity();
+
+		/**
+		* Destroys pooled dead Entities with an ID at or above a limit. The limit becomes
+		* the next new ID, so every ID below it must be active or pooled.
+		* Nothing is released while a SpawnBuffer holds reserved IDs.
+		* @param id - the lowest ID to release
+		*/
+		void releaseDeadEntitiesFrom(Entity::ID id);
+
+		/**
+		* Creates active Entities with specific IDs, which must not be active.
+		* If nextID is above the next new ID, the IDs in between are pooled.
+		* @param ids - IDs of the new active Entities, in ascending order
+		* @param count - number of IDs
+		* @param nextID - the lowest next new ID
+		*/
+		void restoreEntities(const Entity::ID* ids, std::size_t count, Entity::ID nextID);
+
+		/**
+		* Grows the table for a Component type to hold a number of Entities
+		* @param identifier - Identifier for the Component
+		* @param size - the number of Entity slots
+		*/
+		void reserveComponents(const ComponentIdentifier& identifier, std::size_t size);
+
+		/**
+		* Attaches a Component to an Entity without checking System interest
+		* @param entity - The Entity to add the Component to
+		* @param identifier - Identifier for the Component
+		* @param component - Component to add
+		*/
+		void attachComponent(Entity& entity, const ComponentIdentifier& identifier, Component::Ptr component);
+
+		/**
+		* Removes a Component from an Entity without checking System interest
+		* @param entity - The Entity to remove a Component from
+		* @param identifier - Identifier for the Component
+		*/
+		void detachComponent(Entity& entity, const ComponentIdentifier& identifier);
+
+		/**
+		* Reserves a block of new Entity::IDs without creating the Entities, for a SpawnBuffer.
+		* Lock free, and safe to call while the main thread creates Entities.
+		* @param count - the number of IDs
+		* @return the first ID of the block
+		*/
+		Entity::ID reserveIDs(unsigned int count);
+
+		/**
+		* Copies the Component bits of an Entity into the packed signature array.
+		* @param entity - the Entity that changed
+		*/
+		void updateSignature(const Entity& entity);
+
 	private:
 		World&                      mWorld;
 		unsigned int                mActiveEntityCount;
-		Entity::ID                  mNextAvaibleID;
+		std::atomic<Entity::ID>     mNextAvaibleID;
+
+		/** IDs reserved by SpawnBuffers that are not committed yet */
+		std::atomic<unsigned int>   mReservedCount;
 
 		/** Holds all entities with the ID being used as an index */
 		std::vector<Entity::Ptr>   mActiveEntities;
 
-		/** Used as a pool for entity reuse */
-		std::stack<Entity::Ptr>    mDeadEntities;
+		/**
+		* Used as a pool for entity reuse.
+		* Kept as a min-heap on Entity::ID so the lowest free ID is reused first,
+		* which keeps active Entities packed at the front of each table.
+		*/
+		std::vector<Entity::Ptr>   mDeadEntities;
 
 		/**
 		* Holds all Components sorted by its parent Entity and type.
 		* Rows are sorted by ComponentID
 		* Columns are sorted by ID
+		* Rows may be shared with clones until they are written to.
+		*/
+		mutable std::vector<std::shared_ptr<ComponentTable>> mComponentsByType;
+
+		/**
+		* Component bits of each Entity packed into one word, indexed by Entity::ID, with a
+		* bit set for active Entities. Scanned by findMatching().
 		*/
-		std::vector<std::vector<Component::Ptr>> mComponentsByType;
+		std::vector<std::uint64_t>   mSignatures;
 
 		/** Temp container used when retrieving components for a single Entity */
 		std::vector<Component*>      mEntityComponents;
@@ -0,0 +1,363 @@
+#pragma once
+#include "Component.h"
+#include "ComponentIdentifierManager.h"
+#include "Entity.h"
+#include "MemoryReport.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace Atlas
+{
+	template <typename T, std::size_t FIELDS>
+	/**
+	* Base class for Components whose data is stored field by field in the FieldManager.
+	* The Component itself only marks that an Entity owns the type, so it can be used in
+	* System and Query signatures. All fields share a single scalar type.
+	*
+	* Usage Example:
+	~~~~~~~~~~~~~~~~~~
+	* struct PositionComponent : public Atlas::FieldComponent<float, 3>
+	* {
+	*	enum Field { X, Y, Z };
+	* };
+	~~~~~~~~~~~~~~~~~~
+	*/
+	struct FieldComponent : public Component
+	{
+		/** Scalar type of every field */
+		typedef T FieldType;
+
+		/** Number of fields */
+		static const std::size_t FIELD_COUNT = FIELDS;
+	};
+
+	template <typename T>
+	/**
+	* A single field of every Entity, indexed by Entity::ID.
+	* The data is aligned to FieldManager::ALIGNMENT and the size is padded to a whole
+	* number of SIMD registers, so kernels can process the span without a remainder loop.
+	* Entries of Entities that do not own the Component are zero.
+	*/
+	struct FieldSpan
+	{
+		T*                          data;
+		std::size_t                 size;
+
+		T* begin() const { return data; }
+		T* end() const { return data + size; }
+		T& operator[](std::size_t id) const { assert(id < size); return data[id]; }
+	};
+
+	/**
+	* Storage of the fields of one FieldComponent type, used through FieldManager.
+	*/
+	class FieldTableBase : public NonCopyable
+	{
+	public:
+		virtual ~FieldTableBase() {}
+
+		/** Sets every field of an Entity to zero */
+		virtual void clearRow(Entity::ID id) = 0;
+
+		/** Moves every field of an Entity to another, empty Entity::ID */
+		virtual void moveRow(Entity::ID from, Entity::ID to) = 0;
+
+		/** Creates a copy of the table */
+		virtual std::unique_ptr<FieldTableBase> clone() const = 0;
+
+		/** Releases the rows above a number of rows, which belong to no active Entity */
+		virtual void shrink(std::size_t rows) = 0;
+
+		/** Bytes used by rows in use and bytes allocated */
+		virtual MemoryUsage getUsage() const = 0;
+	};
+
+	template <typename T>
+	/**
+	* Storage of the fields of one FieldComponent type.
+	* Each field is an array of T in one aligned allocation; field f starts at f * capacity.
+	*/
+	class FieldTable : public FieldTableBase
+	{
+	public:
+		/** Bytes each array is aligned and padded to, the width of the largest SIMD registers */
+		static const std::size_t ALIGNMENT = 64;
+
+		/** Elements per SIMD register */
+		static const std::size_t LANES = ALIGNMENT / sizeof(T);
+
+		/**
+		* Creates an empty table.
+		* @param fields - the number of fields
+		*/
+		explicit FieldTable(std::size_t fields)
+			: mFields(fields)
+			, mRows(0)
+			, mCapacity(0)
+			, mBuffer()
+			, mData(nullptr)
+		{
+		}
+
+		/**
+		* Retrieves a field of every Entity.
+		* @param field - index of the field
+		*/
+		FieldSpan<T> getField(std::size_t field)
+		{
+			assert(field < mFields);
+			FieldSpan<T> span = { mData + field * mCapacity, mRows };
+			return span;
+		}
+
+		/**
+		* Retrieves a field of a single Entity, growing the table to hold it.
+		* @param id - ID of the Entity
+		* @param field - index of the field
+		*/
+		T& get(Entity::ID id, std::size_t field)
+		{
+			assert(field < mFields);
+			reserve(id + 1);
+			return mData[field * mCapacity + id];
+		}
+
+		/**
+		* Makes sure the table holds a number of rows, all new rows are zero.
+		* @param rows - the number of rows
+		*/
+		void reserve(std::size_t rows)
+		{
+			rows = padded(rows);
+
+			if (rows > mCapacity)
+			{
+				FieldTable grown(mFields);
+				grown.allocate(std::max(rows, mCapacity * 2));
+
+				for (std::size_t field = 0; field < mFields && mCapacity > 0; field++)
+					std::memcpy(grown.mData + field * grown.mCapacity, mData + field * mCapacity, mCapacity * sizeof(T));
+
+				swap(grown);
+			}
+
+			mRows = std::max(mRows, rows);
+		}
+
+		virtual void clearRow(Entity::ID id)
+		{
+			if (id >= mRows)
+				return;
+
+			for (std::size_t field = 0; field < mFields; field++)
+				mData[field * mCapacity + id] = T();
+		}
+
+		virtual void moveRow(Entity::ID from, Entity::ID to)
+		{
+			if (from >= mRows)
+				return;
+
+			reserve(to + 1);
+
+			for (std::size_t field = 0; field < mFields; field++)
+			{
+				mData[field * mCapacity + to] = mData[field * mCapacity + from];
+				mData[field * mCapacity + from] = T();
+			}
+		}
+
+		virtual std::unique_ptr<FieldTableBase> clone() const
+		{
+			std::unique_ptr<FieldTable> copy(new FieldTable(mFields));
+			copy->allocate(mCapacity);
+			copy->mRows = mRows;
+
+			if (mCapacity > 0)
+				std::memcpy(copy->mData, mData, mFields * mCapacity * sizeof(T));
+
+			return std::move(copy);
+		}
+
+		virtual void shrink(std::size_t rows)
+		{
+			rows = padded(rows);
+			mRows = std::min(mRows, rows);
+
+			if (rows >= mCapacity)
+				return;
+
+			FieldTable copy(mFields);
+			copy.allocate(rows);
+
+			for (std::size_t field = 0; field < mFields && rows > 0; field++)
+				std::memcpy(copy.mData + field * rows, mData + field * mCapacity, rows * sizeof(T));
+
+			swap(copy);
+		}
+
+		virtual MemoryUsage getUsage() const
+		{
+			MemoryUsage usage;
+			usage.live = mFields * mRows * sizeof(T);
+			usage.reserved = mFields * mCapacity * sizeof(T) + (mCapacity > 0 ? ALIGNMENT : 0);
+			return usage;
+		}
+
+	private:
+		/** Rounds a number of rows up to a whole number of SIMD registers */
+		static std::size_t padded(std::size_t rows)
+		{
+			return (rows + LANES - 1) / LANES * LANES;
+		}
+
+		/** Allocates zeroed, aligned storage for a number of rows, which must be padded */
+		void allocate(std::size_t capacity)
+		{
+			mCapacity = capacity;
+			mBuffer.reset(new char[mFields * capacity * sizeof(T) + ALIGNMENT]());
+
+			// round the start of the buffer up to the alignment
+			const std::size_t address = reinterpret_cast<std::size_t>(mBuffer.get());
+			mData = reinterpret_cast<T*>((address + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT);
+		}
+
+		void swap(FieldTable& other)
+		{
+			std::swap(mCapacity, other.mCapacity);
+			std::swap(mBuffer, other.mBuffer);
+			std::swap(mData, other.mData);
+		}
+
+	private:
+		std::size_t                 mFields;
+		std::size_t                 mRows;
+		std::size_t                 mCapacity;
+		std::unique_ptr<char[]>     mBuffer;
+		T*                          mData;
+	};
+
+	/**
+	* Stores the data of FieldComponent types as one aligned array per field (SoA), so
+	* kernels over a field can use SIMD instructions on 8 or 16 Entities at a time.
+	*
+	* Fields are indexed by Entity::ID, like the Component tables, so they follow the same
+	* packing; after World::defragment() the arrays are dense. Entries of Entities that do
+	* not own the Component are kept at zero, so a kernel can run over a whole span.
+	* The Entities of a System or Query can also be used as indices into a span.
+	*
+	* Usage Example:
+	~~~~~~~~~~~~~~~~~~
+	* entity.addComponent(Atlas::Component::Ptr(new PositionComponent()));
+	* fManager.get<PositionComponent>(entity.getID(), PositionComponent::X) = 10.0f;
+	*
+	* Atlas::FieldSpan<float> x = fManager.getField<PositionComponent>(PositionComponent::X);
+	* Atlas::FieldSpan<float> vx = fManager.getField<VelocityComponent>(VelocityComponent::X);
+	* for (std::size_t i = 0; i < x.size; i++)
+	*	x.data[i] += vx.data[i] * dt;
+	~~~~~~~~~~~~~~~~~~
+	*/
+	class FieldManager : public NonCopyable
+	{
+	public:
+		/** Default Constructor */
+		FieldManager();
+
+		template <typename T>
+		/**
+		* Retrieves a field of every Entity. Spans of all types have the same size, so
+		* kernels can combine fields of several types. The span is only valid until a
+		* Component is added to an Entity with a higher ID than any before.
+		* @param field - index of the field
+		* @return Aligned span indexed by Entity::ID
+		*/
+		FieldSpan<typename T::FieldType> getField(std::size_t field)
+		{
+			return getTable<T>().getField(field);
+		}
+
+		template <typename T>
+		/**
+		* Retrieves a field of a single Entity.
+		* @param id - ID of the Entity
+		* @param field - index of the field
+		* @return Reference to the field, valid until the table grows
+		*/
+		typename T::FieldType& get(Entity::ID id, std::size_t field)
+		{
+			addRow(id);
+			return getTable<T>().get(id, field);
+		}
+
+		/**
+		* Makes sure spans include an Entity, after it was given a Component.
+		* Called by the EntityManager.
+		* @param id - ID of the Entity
+		*/
+		void addRow(Entity::ID id);
+
+		/**
+		* Sets the fields of an Entity to zero, after it lost a Component type.
+		* Called by the EntityManager.
+		* @param type - ID of the Component type
+		* @param id - ID of the Entity
+		*/
+		void clearRow(unsigned int type, Entity::ID id);
+
+		/**
+		* Moves the fields of relocated Entities to their new IDs.
+		* @param relocations - old and new IDs of the moved Entities
+		*/
+		void remapEntities(const std::vector<Entity::Relocation>& relocations);
+
+		/**
+		* Replaces the fields of another FieldManager with copies of these fields.
+		* @param target - the FieldManager to copy into
+		*/
+		void cloneTo(FieldManager& target) const;
+
+		/**
+		* Adds the memory held by field arrays to a report.
+		* @param report - the report to be filled
+		*/
+		void reportMemory(MemoryReport& report) const;
+
+		/**
+		* Releases the rows above the highest active Entity.
+		* Called by EntityManager::shrinkToFit(), whatever the values of the fields.
+		* @param rows - one past the highest active Entity::ID
+		*/
+		void shrinkToFit(std::size_t rows);
+
+	private:
+		template <typename T>
+		/**
+		* Finds or creates the table of a FieldComponent type.
+		*/
+		FieldTable<typename T::FieldType>& getTable()
+		{
+			const unsigned int type = ComponentIdentifierManager::getID<T>();
+
+			if (mTables[type] == nullptr)
+				mTables[type].reset(new FieldTable<typename T::FieldType>(T::FIELD_COUNT));
+
+			assert(dynamic_cast<FieldTable<typename T::FieldType>*>(mTables[type].get()) != nullptr);
+			auto& table = static_cast<FieldTable<typename T::FieldType>&>(*mTables[type]);
+
+			table.reserve(mRows);
+			return table;
+		}
+
+	private:
+		/** Tables indexed by Component ID, null for types that do not use fields */
+		std::vector<std::unique_ptr<FieldTableBase>>    mTables;
+
+		/** Rows every table holds, one past the highest Entity given a Component */
+		std::size_t                                     mRows;
+	};
+}
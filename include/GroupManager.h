@@ -1,5 +1,6 @@
 #pragma once
 #include "Entity.h"
+#include "MemoryReport.h"
 
 #include <unordered_map>
 
@@ -50,12 +51,37 @@ namespace Atlas
 		*/
 		std::vector<std::string> getEntityGroups(const Entity& entity) const;
 
+		/**
+		* Replaces the IDs of relocated Entities in every group.
+		* @param relocations - old and new IDs of the moved Entities
+		*/
+		void remapEntities(const std::vector<Entity::Relocation>& relocations);
+
+		/**
+		* Replaces the groups of another GroupManager with copies of these groups.
+		* @param target - the GroupManager to copy into
+		*/
+		void cloneTo(GroupManager& target) const;
+
+		/**
+		* Adds the memory held by the group tables to a report.
+		* @param report - the report to be filled
+		*/
+		void reportMemory(MemoryReport& report) const;
+
+		/**
+		* Removes empty groups and releases unused capacity held by the group tables.
+		*/
+		void shrinkToFit();
+
 		/**
 		* Prints each group with the ID's of the Entities that are included.
 		*/
 		void toString();
 
 	private:
+		friend class Snapshot;  // Reads the group tables directly
+
 		/** Holds a table organized as Group - Entities */
 		std::unordered_map < std::string,
 			std::vector < Entity::ID >>              mGroupsByName;
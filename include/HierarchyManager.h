@@ -0,0 +1,197 @@
+#pragma once
+#include "Entity.h"
+#include "MemoryReport.h"
+
+#include <vector>
+
+namespace Atlas
+{
+	class World;
+
+	/**
+	* Parent and child links of a single Entity.
+	* Children form a linked list through their sibling links, so every Entity takes the
+	* same 16 bytes no matter how many children it has.
+	*/
+	struct Relationship
+	{
+		/** Link value for a missing parent, child or sibling */
+		static const Entity::ID NONE = static_cast<Entity::ID>(-1);
+
+		/** Default Constructor */
+		Relationship();
+
+		Entity::ID                  parent;
+		Entity::ID                  firstChild;
+		Entity::ID                  nextSibling;
+		Entity::ID                  prevSibling;
+	};
+
+	/**
+	* Used to organize Entities into parent/child hierarchies, such as transform hierarchies.
+	*
+	* Links are kept in a flat table indexed by Entity::ID. A depth-first order of every
+	* hierarchy, with parents before their children, is rebuilt when the links change, so
+	* transform propagation can run as a single pass. Destroying an Entity destroys its
+	* children on the same World::update().
+	*
+	* Usage Example:
+	~~~~~~~~~~~~~~~~~~
+	* hierarchy.setParent(wheel, car);
+	* for (const auto& id : hierarchy.getDepthFirstOrder())
+	*	updateTransform(id);
+	~~~~~~~~~~~~~~~~~~
+	*/
+	class HierarchyManager : public NonCopyable
+	{
+	public:
+		/**
+		* Creates a new HierarchyManager.
+		* @param world - the World object that owns this HierarchyManager
+		*/
+		explicit HierarchyManager(World& world);
+
+		/**
+		* Makes an Entity the child of another, detaching it from its current parent.
+		* The parent must not be the child itself or one of its descendants.
+		* @param child - the Entity to be attached
+		* @param parent - the new parent
+		*/
+		void setParent(const Entity& child, const Entity& parent);
+
+		/**
+		* Detaches an Entity from its parent, making it a root.
+		* @param child - the Entity to be detached
+		*/
+		void removeParent(const Entity& child);
+
+		/**
+		* Retrieves the parent of an Entity.
+		* @param entity - the Entity of interest
+		* @return ID of the parent, or Relationship::NONE for a root
+		*/
+		Entity::ID getParent(const Entity& entity) const;
+
+		/**
+		* Retrieves the children of an Entity, most recently attached first.
+		* @param entity - the Entity of interest
+		* @return container of Entity::IDs of the children
+		*/
+		std::vector<Entity::ID> getChildren(const Entity& entity) const;
+
+		/**
+		* Checks if an Entity has any children.
+		* @param entity - the Entity of interest
+		*/
+		bool hasChildren(const Entity& entity) const;
+
+		/**
+		* Retrieves the links of an Entity.
+		* @param id - ID of the Entity of interest
+		* @return The links, all Relationship::NONE if the Entity is not in a hierarchy
+		*/
+		const Relationship& getRelationship(Entity::ID id) const;
+
+		/**
+		* Sets every descendant of an Entity inactive, so they are destroyed with it.
+		* Called by the EntityManager for destroyed Entities.
+		* @param entity - the Entity whose descendants are destroyed
+		*/
+		void destroyDescendants(const Entity& entity);
+
+		/**
+		* Retrieves every Entity that has a parent or children, in depth-first order.
+		* Roots come in ID order and each parent comes before its children.
+		* @return container of Entity::IDs
+		*/
+		const std::vector<Entity::ID>& getDepthFirstOrder();
+
+		/**
+		* Sorts Entity::IDs into depth-first order. Entities that are not in a hierarchy
+		* come last, in ID order.
+		* @param ids - the IDs to be sorted
+		*/
+		void sortDepthFirst(std::vector<Entity::ID>& ids);
+
+		/**
+		* Retrieves a counter that changes whenever a link changes.
+		*/
+		unsigned int getVersion() const;
+
+		/**
+		* Unlinks an Entity from its parent, siblings and children.
+		* Called by the EntityManager when the Entity is destroyed.
+		* @param entity - the Entity being destroyed
+		*/
+		void removeEntity(const Entity& entity);
+
+		/**
+		* Replaces the IDs of relocated Entities in every link.
+		* @param relocations - old and new IDs of the moved Entities
+		*/
+		void remapEntities(const std::vector<Entity::Relocation>& relocations);
+
+		/**
+		* Replaces the links of another HierarchyManager with copies of these links.
+		* @param target - the HierarchyManager to copy into
+		*/
+		void cloneTo(HierarchyManager& target) const;
+
+		/**
+		* Adds the memory held by the link tables to a report.
+		* @param report - the report to be filled
+		*/
+		void reportMemory(MemoryReport& report) const;
+
+		/**
+		* Releases unused capacity held by the link tables.
+		*/
+		void shrinkToFit();
+
+		/**
+		* Prints each hierarchy in depth-first order.
+		*/
+		void toString();
+
+	private:
+		/**
+		* Unlinks an Entity from its parent and siblings.
+		* @param id - ID of the Entity
+		*/
+		void detach(Entity::ID id);
+
+		/**
+		* Checks if an Entity is an ancestor of another, or the same Entity.
+		* @param ancestor - ID of the possible ancestor
+		* @param id - ID of the Entity of interest
+		*/
+		bool isAncestor(Entity::ID ancestor, Entity::ID id) const;
+
+		/**
+		* Makes sure the link table holds an Entity
+		* @param id - ID of the Entity
+		*/
+		void grow(Entity::ID id);
+
+		/** Invalidates the depth-first order after a link changed */
+		void markChanged();
+
+		/** Rebuilds the depth-first order if any link changed */
+		void sort();
+
+	private:
+		World&                          mWorld;
+
+		/** Links, indexed by Entity::ID */
+		std::vector<Relationship>       mRelationships;
+
+		/** Linked Entities in depth-first order */
+		std::vector<Entity::ID>         mDepthFirst;
+
+		/** Position of each Entity in mDepthFirst, indexed by Entity::ID */
+		std::vector<Entity::ID>         mRanks;
+
+		unsigned int                    mVersion;
+		bool                            mIsSorted;
+	};
+}
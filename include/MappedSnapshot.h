@@ -0,0 +1,108 @@
+#pragma once
+#include "Snapshot.h"
+#include "NonCopyable.h"
+#include "ComponentIdentifierManager.h"
+#include "ComponentIdentifier.h"
+
+#include <string>
+
+namespace Atlas
+{
+	/**
+	* A snapshot file mapped into memory.
+	* The file is mapped privately: pages are shared with the OS file cache and are only
+	* copied if they are written to, and writes never reach the file. Blocks can be read in
+	* place, or the snapshot can be loaded into a World without reading the file into a buffer.
+	*
+	* Usage Example:
+	~~~~~~~~~~~~~~~~~~
+	* Atlas::MappedSnapshot snapshot("terrain.snapshot");
+	* world.loadSnapshot(snapshot);
+	*
+	* // or read static data in place
+	* const Atlas::SnapshotBlock* heights = snapshot.getBlock<HeightComponent>();
+	~~~~~~~~~~~~~~~~~~
+	*/
+	class MappedSnapshot : public NonCopyable
+	{
+	public:
+		/** Default Constructor */
+		MappedSnapshot();
+
+		/**
+		* Maps a snapshot file.
+		* @param path - the file to be mapped
+		*/
+		explicit MappedSnapshot(const std::string& path);
+
+		~MappedSnapshot();
+
+		/**
+		* Maps a snapshot file, replacing any file that is already mapped.
+		* @param path - the file to be mapped
+		* @return True if the file was mapped and is a valid snapshot
+		*/
+		bool open(const std::string& path);
+
+		/**
+		* Unmaps the file. Pointers into the snapshot become invalid.
+		*/
+		void close();
+
+		/**
+		* Checks if a valid snapshot is mapped.
+		*/
+		bool isOpen() const;
+
+		/**
+		* Retrieves the mapped data. Writes are private to this process.
+		*/
+		char* getData();
+
+		/**
+		* Retrieves the mapped data.
+		*/
+		const char* getData() const;
+
+		/**
+		* Retrieves the size of the mapped data in bytes.
+		*/
+		std::size_t getSize() const;
+
+		/**
+		* Retrieves the layout of the snapshot.
+		*/
+		const SnapshotContents& getContents() const;
+
+		/**
+		* Finds the block for a Component type.
+		* @param name - name of the Component type
+		* @return the block, or nullptr if the snapshot does not hold the type
+		*/
+		const SnapshotBlock* getBlock(const std::string& name) const;
+
+		template <typename T>
+		/**
+		* Finds the block for a Component type.
+		*
+		* Usage Example:
+		~~~~~~~~~~~~~~~~~~
+		* const Atlas::SnapshotBlock* heights = snapshot.getBlock<HeightComponent>();
+		~~~~~~~~~~~~~~~~~~
+		* @return the block, or nullptr if the snapshot does not hold the type
+		*/
+		const SnapshotBlock* getBlock() const
+		{
+			return getBlock(ComponentIdentifierManager::getType<T>().getName());
+		}
+
+	private:
+		char*                       mData;
+		std::size_t                 mSize;
+		SnapshotContents            mContents;
+
+		/** OS handles for the file and the mapping, unused on POSIX systems */
+		void*                       mFile;
+		void*                       mMapping;
+	};
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Atlas
+{
+	/**
+	* Byte counts for a single storage area.
+	*/
+	struct MemoryUsage
+	{
+		/** Default Constructor */
+		MemoryUsage();
+
+		/**
+		* Accumulates the counts of another storage area.
+		* @param other - the usage to be added
+		*/
+		MemoryUsage& operator+=(const MemoryUsage& other);
+
+		/** Bytes held by live entries */
+		std::size_t             live;
+
+		/** Bytes allocated, including unused capacity */
+		std::size_t             reserved;
+	};
+
+	/**
+	* Breakdown of the memory held by a World.
+	* Created through World::memoryReport().
+	*/
+	struct MemoryReport
+	{
+		/**
+		* Memory held for a single Component type.
+		* Object bytes are only known for Component types that have been used through
+		* one of the templated ComponentIdentifierManager functions.
+		*/
+		struct ComponentUsage
+		{
+			std::string         name;
+			unsigned int        id;
+			unsigned int        count;
+			MemoryUsage         usage;
+		};
+
+		/**
+		* Sums every storage area in the report.
+		* @return Total memory usage
+		*/
+		MemoryUsage total() const;
+
+		/**
+		* Prints the usage of each storage area.
+		*/
+		void toString() const;
+
+		/** Component storage, one entry per Component type in use */
+		std::vector<ComponentUsage>     components;
+
+		/** Entity table and the pool of dead Entities */
+		MemoryUsage                     entities;
+
+		/** Systems and the Entity lists of cached queries */
+		MemoryUsage                     systems;
+
+		/** Group tables held by the GroupManager */
+		MemoryUsage                     groups;
+
+		/** Link tables held by the HierarchyManager */
+		MemoryUsage                     hierarchy;
+
+		/** Field arrays held by the FieldManager */
+		MemoryUsage                     fields;
+	};
+}
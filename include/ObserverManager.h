@@ -0,0 +1,243 @@
+#pragma once
+#include "Bitsize.h"
+#include "Component.h"
+#include "ComponentIdentifierManager.h"
+#include "Entity.h"
+#include "NonCopyable.h"
+
+#include <bitset>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace Atlas
+{
+	class World;
+
+	template <typename T>
+	/**
+	* The Components of one type that were constructed or destroyed since the last dispatch,
+	* handed to an observer in one call so it can do its work in bulk.
+	*/
+	class ObserverBatch
+	{
+	public:
+		/**
+		* Creates a view of the events of a type.
+		* @param ids - the Entities, in ID order
+		* @param components - the Component of each Entity
+		*/
+		ObserverBatch(const std::vector<Entity::ID>& ids, const std::vector<Component*>& components)
+			: mIDs(ids)
+			, mComponents(components)
+		{
+		}
+
+		/** Retrieves the number of Components in the batch */
+		std::size_t size() const
+		{
+			return mIDs.size();
+		}
+
+		/** Retrieves the Entity of every Component in the batch, in ID order */
+		const std::vector<Entity::ID>& getIDs() const
+		{
+			return mIDs;
+		}
+
+		/**
+		* Retrieves the Entity of a Component in the batch.
+		* @param index - position in the batch
+		*/
+		Entity::ID getID(std::size_t index) const
+		{
+			return mIDs[index];
+		}
+
+		/**
+		* Retrieves a Component in the batch.
+		* @param index - position in the batch
+		*/
+		T* getComponent(std::size_t index) const
+		{
+			return static_cast<T*>(mComponents[index]);
+		}
+
+	private:
+		const std::vector<Entity::ID>&      mIDs;
+		const std::vector<Component*>&      mComponents;
+	};
+
+	/**
+	* Calls observers when Components of a type are constructed or destroyed, for side effects
+	* such as creating physics bodies or releasing sound handles.
+	*
+	* Events are collected by the EntityManager as Components are added and removed, and
+	* dispatched once per World::update(), after dead Entities are released and before the
+	* Systems update. Each observer is called once per type with every event of the frame, so
+	* a handler can do a single batch insert instead of one call per Component.
+	*
+	* For each type the destroy observers are called before the construct observers, so a
+	* replaced Component is released before its replacement is set up. A Component that is
+	* added and removed again between dispatches is never reported. Destroyed Components are
+	* kept alive until their observers return, so handlers can read them.
+	*
+	* Usage Example:
+	~~~~~~~~~~~~~~~~~~
+	* oManager.onConstruct<BodyComponent>([&physics](const Atlas::ObserverBatch<BodyComponent>& batch)
+	* {
+	*	physics.insertBodies(batch);
+	* });
+	*
+	* oManager.onDestroy<BodyComponent>([&physics](const Atlas::ObserverBatch<BodyComponent>& batch)
+	* {
+	*	physics.removeBodies(batch);
+	* });
+	~~~~~~~~~~~~~~~~~~
+	*/
+	class ObserverManager : public NonCopyable
+	{
+	public:
+		/** Untyped observer, called with the events of a single type */
+		typedef std::function<void(const std::vector<Entity::ID>&, const std::vector<Component*>&)> Observer;
+
+		/**
+		* Creates a new ObserverManager.
+		* @param world - the World the observed Components belong to
+		*/
+		explicit ObserverManager(World& world);
+
+		template <typename T>
+		/**
+		* Adds an observer that is called with the Components of a type added since the last dispatch.
+		* Components that were removed again before the dispatch are left out.
+		* @param observer - the function to call
+		*/
+		void onConstruct(std::function<void(const ObserverBatch<T>&)> observer)
+		{
+			addObserver(mConstructObservers, ComponentIdentifierManager::getID<T>(), wrap(observer));
+		}
+
+		template <typename T>
+		/**
+		* Adds an observer that is called with the Components of a type removed since the last dispatch.
+		* The Components are destroyed after every observer of the type has returned.
+		* @param observer - the function to call
+		*/
+		void onDestroy(std::function<void(const ObserverBatch<T>&)> observer)
+		{
+			addObserver(mDestroyObservers, ComponentIdentifierManager::getID<T>(), wrap(observer));
+		}
+
+		template <typename T>
+		/**
+		* Removes every construct and destroy observer of a type, events not yet dispatched are dropped.
+		*/
+		void removeObservers()
+		{
+			removeObservers(ComponentIdentifierManager::getID<T>());
+		}
+
+		/**
+		* Calls the observers with every event collected since the last dispatch.
+		* Called by World::update(); events raised by the observers are kept for the next dispatch.
+		*/
+		void dispatch();
+
+		/**
+		* Records that an Entity was given a Component. Called by the EntityManager.
+		* @param type - ID of the Component type
+		* @param id - ID of the Entity
+		* @param component - the new Component
+		*/
+		void constructed(unsigned int type, Entity::ID id, Component* component)
+		{
+			if (mIsObserved[type])
+				recordConstructed(type, id, component);
+		}
+
+		/**
+		* Records that an Entity is losing a Component. Called by the EntityManager before
+		* the Component is released; the Component is taken if the type has destroy observers.
+		* @param type - ID of the Component type
+		* @param id - ID of the Entity
+		* @param component - the entry of the Component in its table
+		*/
+		void destroyed(unsigned int type, Entity::ID id, Component::Ptr& component)
+		{
+			if (mIsObserved[type])
+				recordDestroyed(type, id, component);
+		}
+
+		/**
+		* Moves the events of relocated Entities to their new IDs.
+		* @param relocations - old and new IDs of the moved Entities
+		*/
+		void remapEntities(const std::vector<Entity::Relocation>& relocations);
+
+		/**
+		* Points events at the copies of their Components, after a table shared with a clone
+		* was copied. Called by the EntityManager.
+		* @param type - ID of the Component type
+		* @param from - the table that was copied
+		* @param to - the copy
+		*/
+		void remapComponents(unsigned int type, const std::vector<Component::Ptr>& from, const std::vector<Component::Ptr>& to);
+
+		/**
+		* Drops every event not yet dispatched, when the Components of the World are replaced
+		* without being added or removed, such as by World::clone().
+		*/
+		void clear();
+
+	private:
+		/** Events of one Component type, in the order they were raised */
+		struct Events
+		{
+			std::vector<std::pair<Entity::ID, Component*>>          constructed;
+			std::vector<std::pair<Entity::ID, Component::Ptr>>      destroyed;
+		};
+
+		template <typename T>
+		/** Wraps a typed observer so it can be stored with observers of other types */
+		static Observer wrap(std::function<void(const ObserverBatch<T>&)> observer)
+		{
+			return [observer](const std::vector<Entity::ID>& ids, const std::vector<Component*>& components)
+			{
+				observer(ObserverBatch<T>(ids, components));
+			};
+		}
+
+		void addObserver(std::vector<std::vector<Observer>>& observers, unsigned int type, Observer observer);
+		void removeObservers(unsigned int type);
+
+		void recordConstructed(unsigned int type, Entity::ID id, Component* component);
+		void recordDestroyed(unsigned int type, Entity::ID id, Component::Ptr& component);
+
+		/** Calls the observers of a type with the events in mDispatching */
+		void dispatch(unsigned int type);
+
+	private:
+		World&                                  mWorld;
+
+		/** Observers indexed by Component ID */
+		std::vector<std::vector<Observer>>      mConstructObservers;
+		std::vector<std::vector<Observer>>      mDestroyObservers;
+
+		/** Types with at least one observer, the only types events are recorded for */
+		std::bitset<BITSIZE>                    mIsObserved;
+
+		/** Set while observers are called, they must not add or remove observers */
+		bool                                    mIsDispatching;
+
+		/** Events not yet dispatched, indexed by Component ID */
+		std::vector<Events>                     mPending;
+
+		/** Events being dispatched, kept so their memory is reused */
+		Events                                  mDispatching;
+
+		/** Scratch buffers for the batches handed to observers */
+		std::vector<Entity::ID>                 mIDs;
+		std::vector<Component*>                 mComponents;
+	};
+}
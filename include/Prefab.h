@@ -0,0 +1,83 @@
+#pragma once
+#include "Bitsize.h"
+#include "Component.h"
+#include "ComponentIdentifier.h"
+#include "ComponentIdentifierManager.h"
+#include "NonCopyable.h"
+
+#include <cassert>
+#include <vector>
+
+namespace Atlas
+{
+	/**
+	* A set of Components that many Entities are created with, such as an enemy archetype.
+	*
+	* The Component types of a Prefab are known up front, so EntityManager::instantiate()
+	* creates any number of Entities at once: each Component is copied from its prototype,
+	* the Component bits are set once per Entity and every Query is tested once for the
+	* whole batch, instead of one interest check per added Component.
+	*
+	* Usage Example:
+	~~~~~~~~~~~~~~~~~~
+	* Atlas::Prefab grunt;
+	* grunt.addComponent(HealthComponent(50)).addComponent(WeaponComponent(RIFLE));
+	*
+	* std::vector<Atlas::Entity::ID> wave = world.getEntityManager().instantiate(grunt, 20);
+	~~~~~~~~~~~~~~~~~~
+	*/
+	class Prefab : public NonCopyable
+	{
+	public:
+		/** Default Constructor */
+		Prefab();
+
+		template <typename T>
+		/**
+		* Adds a Component that every instance receives a copy of. A Component of a type
+		* the Prefab already has replaces it. The type must be copy constructible.
+		* @param component - the prototype to be copied
+		* @return the Prefab, so calls can be chained
+		*/
+		Prefab& addComponent(const T& component)
+		{
+			const ComponentIdentifier& identifier = ComponentIdentifierManager::getType<T>();
+			assert(identifier.getCopyFunction() != nullptr && "Prefab Components must be copy constructible");
+
+			setPrototype(identifier, Component::Ptr(new T(component)));
+			return *this;
+		}
+
+		/**
+		* Retrieves the Component bits every instance owns.
+		*/
+		std::bitset<BITSIZE> getComponentBits() const;
+
+	private:
+		friend class EntityManager;  // Copies the prototypes into new Entities
+
+		/** A Component type of the Prefab and the value instances start with */
+		struct Prototype
+		{
+			Prototype(const ComponentIdentifier& identifier, Component::Ptr component);
+
+			// VS2013 does not generate moves, and the Component can not be copied
+			Prototype(Prototype&& other);
+			Prototype& operator=(Prototype&& other);
+
+			const ComponentIdentifier*  identifier;
+			Component::Ptr              component;
+		};
+
+		/**
+		* Adds or replaces the prototype of a Component type.
+		* @param identifier - Identifier for the Component
+		* @param component - the prototype
+		*/
+		void setPrototype(const ComponentIdentifier& identifier, Component::Ptr component);
+
+	private:
+		std::vector<Prototype>          mPrototypes;
+		std::bitset<BITSIZE>            mComponentBits;
+	};
+}
@@ -0,0 +1,174 @@
+#pragma once
+#include "Bitsize.h"
+#include "NonCopyable.h"
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+/**
+* Set to 1 to compile the structural change counters into the EntityManager and SystemManager.
+* With 0, the default, ATLAS_PROFILE expands to nothing and World::profileReport() is empty.
+*/
+#ifndef ATLAS_PROFILING
+#define ATLAS_PROFILING 0
+#endif
+
+#if ATLAS_PROFILING
+#define ATLAS_PROFILE(profiler, operation, type) Atlas::Profiler::Scope atlasProfileScope((profiler), (operation), (type), 1)
+#define ATLAS_PROFILE_BATCH(profiler, operation, type, count) Atlas::Profiler::Scope atlasProfileScope((profiler), (operation), (type), (count))
+#else
+#define ATLAS_PROFILE(profiler, operation, type) ((void)0)
+#define ATLAS_PROFILE_BATCH(profiler, operation, type, count) ((void)0)
+#endif
+
+namespace Atlas
+{
+	/** Counters of one thread, defined in Profiler.cpp */
+	struct ProfileBlock;
+
+	/**
+	* Counts and sampled latency of one kind of structural change.
+	*/
+	struct OperationStats
+	{
+		/** Default Constructor */
+		OperationStats();
+
+		/**
+		* Retrieves the average time of the timed calls.
+		* @return Microseconds per call, 0 if no call was timed
+		*/
+		double averageMicroseconds() const;
+
+		/** Number of calls */
+		unsigned long long                  calls;
+
+		/** Number of calls that were timed, one call or batch in Profiler::SAMPLE_INTERVAL */
+		unsigned long long                  samples;
+
+		/** Total time of the timed calls, in nanoseconds */
+		unsigned long long                  sampledNanoseconds;
+
+		/** Calls per Component type, indexed by Component ID; empty for operations without a type */
+		std::vector<unsigned long long>     byType;
+	};
+
+	/**
+	* Structural changes made to a World since the last report.
+	* Created through World::profileReport().
+	*/
+	struct ProfileReport
+	{
+		/**
+		* Prints the counts and average latency of each operation.
+		*/
+		void toString() const;
+
+		/** Figures of each operation, indexed by Profiler::Operation */
+		std::vector<OperationStats>         operations;
+	};
+
+	/**
+	* Counts structural changes of a World: Components added and removed per type, Entities
+	* created and reaped and interest checks, and times one call in SAMPLE_INTERVAL.
+	*
+	* Each thread counts into its own block, so counting never takes a lock or contends with
+	* other threads. A block is only written by its thread; report() sums the blocks
+	* with relaxed atomic loads, so a report can be taken while other threads count.
+	* Counting is compiled in when ATLAS_PROFILING is 1.
+	*
+	* Usage Example:
+	~~~~~~~~~~~~~~~~~~
+	* world.update(dt);
+	*
+	* Atlas::ProfileReport frame = world.profileReport();
+	* if (frame.operations[Atlas::Profiler::ADD_COMPONENT].calls > 1000)
+	*	frame.toString();
+	~~~~~~~~~~~~~~~~~~
+	*/
+	class Profiler : public NonCopyable
+	{
+	public:
+		enum Operation
+		{
+			ADD_COMPONENT,      // addComponent(), prefabs, SpawnBuffer commits and snapshot loads
+			REMOVE_COMPONENT,   // EntityManager::removeComponent()
+			CREATE_ENTITY,      // createEntity(), SpawnBuffer commits and snapshot loads
+			REAP_ENTITY,        // EntityManager::removeEntity(), for Entities set inactive
+			CHECK_INTEREST,     // SystemManager::checkInterest()
+			OPERATION_COUNT
+		};
+
+		/** Type passed for operations that are not counted per Component type */
+		static const unsigned int NO_TYPE = BITSIZE;
+
+		/** One call in this many is timed */
+		static const unsigned int SAMPLE_INTERVAL = 64;
+
+		/**
+		* Counts a call for the lifetime of the scope, and times it if it is sampled.
+		* Created by the ATLAS_PROFILE macro.
+		*/
+		class Scope : public NonCopyable
+		{
+		public:
+			/**
+			* Counts a call, or a batch of calls made at once.
+			* A sampled batch counts as that many timed calls, so averages stay per call.
+			* @param profiler - the Profiler of the World
+			* @param operation - the kind of call
+			* @param type - ID of the Component type, or NO_TYPE
+			* @param count - the number of calls in the batch
+			*/
+			Scope(Profiler& profiler, Operation operation, unsigned int type, unsigned long long count);
+
+			/** Records the time of a sampled call */
+			~Scope();
+
+		private:
+			typedef std::chrono::steady_clock Clock;
+
+			ProfileBlock*           mBlock;
+			Operation               mOperation;
+			unsigned long long      mCount;
+			bool                    mIsSampled;
+			Clock::time_point       mStart;
+		};
+
+		/** Default Constructor */
+		Profiler();
+
+		/** Destructor, releases the blocks of every thread */
+		~Profiler();
+
+		/**
+		* Sums the blocks of every thread.
+		* Called from a single thread, as each report is relative to the one before.
+		* @return The changes since the last report
+		*/
+		ProfileReport report();
+
+	private:
+		/**
+		* Retrieves the block of the calling thread, creating it on first use.
+		*/
+		ProfileBlock& getBlock();
+
+		/** Searches for the block of the calling thread, adding one if there is none */
+		ProfileBlock& findBlock();
+
+		/** Sums every block */
+		ProfileReport sum() const;
+
+	private:
+		/** Identifies the Profiler in the block cache of each thread, never reused */
+		const unsigned long long            mSerial;
+
+		/** Blocks of every thread that counted into the Profiler, only ever pushed to the front */
+		std::atomic<ProfileBlock*>          mBlocks;
+
+		/** Totals at the last report */
+		ProfileReport                       mLast;
+	};
+}
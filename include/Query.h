@@ -0,0 +1,171 @@
+#pragma once
+#include "Bitsize.h"
+#include "Entity.h"
+#include "ComponentIdentifierManager.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Atlas
+{
+	class System;
+	class HierarchyManager;
+
+	/**
+	* Describes the Entities a query selects by the Component types they own.
+	*
+	* Usage Example:
+	~~~~~~~~~~~~~~~~~~
+	* Atlas::Signature signature;
+	* signature.require<PositionComponent>().exclude<FrozenComponent>();
+	~~~~~~~~~~~~~~~~~~
+	*/
+	struct Signature
+	{
+		template <typename T>
+		/**
+		* Adds a Component type that matching Entities must own.
+		*/
+		Signature& require()
+		{
+			required |= ComponentIdentifierManager::getBits<T>();
+			return *this;
+		}
+
+		template <typename T>
+		/**
+		* Adds a Component type that matching Entities must not own.
+		*/
+		Signature& exclude()
+		{
+			excluded |= ComponentIdentifierManager::getBits<T>();
+			return *this;
+		}
+
+		template <typename T>
+		/**
+		* Adds a Component type that is read when present, but does not affect matching.
+		*/
+		Signature& include()
+		{
+			optional |= ComponentIdentifierManager::getBits<T>();
+			return *this;
+		}
+
+		/**
+		* Checks if a set of Component types matches the Signature.
+		* Required and excluded types are tested together, with a single AND against
+		* both sets and a compare to the required set.
+		* @param componentBits - the Component bits of an Entity
+		*/
+		bool matches(const std::bitset<BITSIZE>& componentBits) const;
+
+		/**
+		* Checks if two Signatures select the same Entities.
+		* Optional types are not compared, as they do not affect matching.
+		* @param other - the Signature to compare to
+		*/
+		bool selectsSame(const Signature& other) const;
+
+		std::bitset<BITSIZE>        required;
+		std::bitset<BITSIZE>        excluded;
+		std::bitset<BITSIZE>        optional;
+	};
+
+	/**
+	* A cached list of the Entities that match a Signature.
+	* Queries are created by the QueryManager and kept up to date as Components are
+	* added and removed. Systems that select the same Entities share a single Query.
+	*/
+	class Query : public NonCopyable
+	{
+	public:
+		/**
+		* Creates a new, empty Query.
+		* @param signature - the Entities to be selected
+		*/
+		explicit Query(const Signature& signature);
+
+		/**
+		* Retrieves the Entity::IDs of the matching Entities.
+		* @return Container of Entity::IDs
+		*/
+		const std::vector<Entity::ID>& getEntities() const;
+
+		/**
+		* Checks if an Entity is in the Query.
+		* @param id - ID of the Entity of interest
+		*/
+		bool contains(Entity::ID id) const;
+
+		/**
+		* Retrieves the Signature of the Query.
+		*/
+		const Signature& getSignature() const;
+
+		/**
+		* Prints the Entities in the Query and its Signature.
+		*/
+		void toString();
+
+	private:
+		friend class QueryManager;   // Maintains the Entity list
+		friend class SystemManager;  // Sorts the Entity list for depth-first Systems
+		friend class System;         // Forwards System::checkInterest()
+
+		/**
+		* Adds or removes an Entity after its Components changed.
+		* @param entity - the Entity to be checked
+		*/
+		void checkInterest(Entity& entity);
+
+		/**
+		* Adds an Entity and notifies the Systems that share the Query.
+		* @param entity - the Entity to be added
+		*/
+		void add(Entity& entity);
+
+		/**
+		* Removes an Entity and notifies the Systems that share the Query.
+		* @param entity - the Entity to be removed
+		*/
+		void remove(Entity& entity);
+
+		/**
+		* Sorts the Entity list into the depth-first order of a hierarchy, if it
+		* or the hierarchy changed since the last sort.
+		* @param hierarchy - the HierarchyManager of the World
+		*/
+		void sortDepthFirst(HierarchyManager& hierarchy);
+
+		/** Rebuilds the position of each Entity after the list was reordered */
+		void updatePositions();
+
+		/**
+		* Checks if a set of Component types matches the Signature of the Query.
+		* @param componentBits - the Component bits of an Entity
+		*/
+		bool matches(const std::bitset<BITSIZE>& componentBits) const;
+
+	private:
+		/** Position of an Entity that is not in the Query */
+		static const std::uint32_t NONE = static_cast<std::uint32_t>(-1);
+
+		Signature                       mSignature;
+
+		/** Required and excluded types, the bits that decide a match */
+		std::bitset<BITSIZE>            mMask;
+
+		std::vector<Entity::ID>         mEntities;
+
+		/** Index of each Entity in mEntities, indexed by Entity::ID */
+		std::vector<std::uint32_t>      mPositions;
+
+		/** Systems that share the Query */
+		std::vector<System*>            mSystems;
+
+		/** Depth-first ordering state, see System::setDepthFirst() */
+		bool                            mIsSorted;
+		unsigned int                    mSortedVersion;
+	};
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include "Query.h"
+#include "MemoryReport.h"
+
+#include <memory>
+#include <vector>
+
+namespace Atlas
+{
+	class World;
+	class System;
+
+	/**
+	* A cache of Query results shared by Systems and gameplay code.
+	*
+	* Each distinct Signature has a single Query, so Systems that process the same
+	* Component types share one Entity list and every change to an Entity is matched
+	* once per Signature, not once per System. Queries stay cached for the life of the World.
+	*
+	* Usage Example:
+	~~~~~~~~~~~~~~~~~~
+	* Atlas::Signature signature;
+	* signature.require<HealthComponent>().exclude<InvulnerableComponent>();
+	*
+	* const Atlas::Query& damageable = world.getQueryManager().getQuery(signature);
+	* for (const auto& id : damageable.getEntities())
+	*	applyDamage(id);
+	~~~~~~~~~~~~~~~~~~
+	*/
+	class QueryManager : public NonCopyable
+	{
+	public:
+		/**
+		* Creates a new QueryManager.
+		* @param world - the World object that owns this QueryManager
+		*/
+		explicit QueryManager(World& world);
+
+		/**
+		* Retrieves the Query for a Signature, creating it from the current Entities
+		* the first time the Signature is used.
+		* @param signature - the Entities to be selected
+		* @return Reference to the cached Query
+		*/
+		const Query& getQuery(const Signature& signature);
+
+		/**
+		* Adds or removes an Entity from every Query after its Components changed.
+		* @param entity - the Entity to be checked
+		*/
+		void checkInterest(Entity& entity);
+
+		/**
+		* Adds new Entities that all own the same Component types to the matching Queries,
+		* testing each Query once. Called by EntityManager::instantiate().
+		* @param componentBits - the Component bits of every Entity
+		* @param ids - IDs of the Entities, which must not be in any Query
+		*/
+		void addEntities(const std::bitset<BITSIZE>& componentBits, const std::vector<Entity::ID>& ids);
+
+		/**
+		* Connects a System to the Query for its Component types.
+		* The System is notified of every Entity already in the Query.
+		* Called by the SystemManager when a System is added.
+		* @param system - the System to be connected
+		*/
+		void attach(System& system);
+
+		/**
+		* Brings every Query up to date with a single sweep over the Entities per Query,
+		* after Components were attached without interest checks, such as by a snapshot load.
+		* Systems are notified of the Entities that joined or left.
+		*/
+		void rebuild();
+
+		/**
+		* Replaces the IDs of relocated Entities in every Query.
+		* @param relocations - old and new IDs of the moved Entities
+		*/
+		void remapEntities(const std::vector<Entity::Relocation>& relocations);
+
+		/**
+		* Sorts the Entity list of every Query by ID, so Systems walk
+		* Component tables from front to back.
+		*/
+		void sortEntities();
+
+		/**
+		* Copies the Entity lists of Queries into the Queries of another QueryManager.
+		* Queries without a match are rebuilt from the Entities of the other World, so this
+		* is called once its Entities and Components are in place.
+		* @param target - the QueryManager to copy into
+		*/
+		void cloneTo(QueryManager& target) const;
+
+		/**
+		* Adds the memory held by Query Entity lists to a report.
+		* @param report - the report to be filled
+		*/
+		void reportMemory(MemoryReport& report) const;
+
+		/**
+		* Releases unused capacity held by Query Entity lists.
+		*/
+		void shrinkToFit();
+
+		/**
+		* Prints every Query.
+		*/
+		void toString();
+
+	private:
+		/**
+		* Finds or creates the Query for a Signature.
+		* @param signature - the Entities to be selected
+		*/
+		Query& findOrCreate(const Signature& signature);
+
+		/**
+		* Fills a Query with the matching Entities of the World.
+		* @param query - the Query to be filled
+		*/
+		void fill(Query& query);
+
+	private:
+		World&                                  mWorld;
+		std::vector<std::unique_ptr<Query>>     mQueries;
+
+		/** Temp container for the matches of a sweep */
+		std::vector<Entity::ID>                 mMatches;
+	};
+}
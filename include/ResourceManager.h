@@ -0,0 +1,200 @@
+#pragma once
+#include "Bitsize.h"
+#include "NonCopyable.h"
+#include "TypeRegistry.h"
+
+#include <atomic>
+#include <bitset>
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+namespace Atlas
+{
+	/**
+	* Holds one object of each resource type for a World: global state such as the input
+	* snapshot, the game clock or a navmesh handle, which would otherwise be kept on a dummy
+	* Entity or in a global.
+	*
+	* Each resource type is given an index the first time it is used, cached in a static of
+	* the accessor, so get<>() is a single array lookup. Like Component types, at most
+	* BITSIZE resource types can be used.
+	*
+	* Systems declare the resources they use with System::readsResource<>() and
+	* System::writesResource<>(), so the SystemManager never runs an update while an
+	* asynchronous update that conflicts with it is in flight.
+	*
+	* Usage Example:
+	~~~~~~~~~~~~~~~~~~
+	* world.getResourceManager().set(GameClock());
+	*
+	* GameClock& clock = world.getResourceManager().get<GameClock>();
+	* clock.elapsed += dt;
+	~~~~~~~~~~~~~~~~~~
+	*/
+	class ResourceManager : public NonCopyable
+	{
+	public:
+		/** Default Constructor */
+		ResourceManager();
+
+		template <typename T>
+		/**
+		* Retrieves the index of a resource type, assigning one if the type has none.
+		* Indices are shared by every World.
+		*/
+		static unsigned int getIndex()
+		{
+			// registered once per type, later calls read the cached index, stored plus one so zero means none
+			unsigned int index = Cache<T>::index.load(std::memory_order_acquire);
+
+			if (index == 0)
+			{
+				index = getIndex(typeid(T)) + 1;
+				Cache<T>::index.store(index, std::memory_order_release);
+			}
+
+			return index - 1;
+		}
+
+		template <typename T>
+		/**
+		* Retrieves the bit of a resource type, as used by System resource declarations.
+		*/
+		static std::bitset<BITSIZE> getBits()
+		{
+			return std::bitset<BITSIZE>().set(getIndex<T>());
+		}
+
+		template <typename T>
+		/**
+		* Stores a resource, replacing the resource of the same type if there is one.
+		* @param resource - the resource, moved into the ResourceManager
+		* @return Reference to the stored resource
+		*/
+		T& set(T resource)
+		{
+			TypedResource<T>* stored = new TypedResource<T>(new T(std::move(resource)));
+			setSlot(getIndex<T>(), Resource::Ptr(stored), stored->resource.get());
+
+			return *stored->resource;
+		}
+
+		template <typename T>
+		/**
+		* Retrieves a resource, which must have been set.
+		*/
+		T& get() const
+		{
+			const Slot& slot = mSlots[getIndex<T>()];
+			assert(slot.data != nullptr && "Resource was not set");
+
+			return *static_cast<T*>(slot.data);
+		}
+
+		template <typename T>
+		/**
+		* Retrieves a resource.
+		* @return Pointer to the resource, or nullptr if it was not set
+		*/
+		T* find() const
+		{
+			return static_cast<T*>(mSlots[getIndex<T>()].data);
+		}
+
+		template <typename T>
+		/**
+		* Checks if a resource was set.
+		*/
+		bool has() const
+		{
+			return mSlots[getIndex<T>()].data != nullptr;
+		}
+
+		template <typename T>
+		/**
+		* Destroys a resource, if it was set.
+		*/
+		void remove()
+		{
+			setSlot(getIndex<T>(), nullptr, nullptr);
+		}
+
+		/**
+		* Replaces the resources of another ResourceManager with copies of these resources.
+		* Resources that can not be copied, or that this ResourceManager does not have, are left
+		* as they are in the target.
+		* @param target - the ResourceManager to copy into
+		*/
+		void cloneTo(ResourceManager& target) const;
+
+	private:
+		/** Owns a resource of any type */
+		struct Resource : public NonCopyable
+		{
+			typedef std::unique_ptr<Resource> Ptr;
+
+			/** Creates a copy of the resource, or nullptr if the type can not be copied */
+			virtual Ptr clone(void*& data) const = 0;
+		};
+
+		template <typename T>
+		struct TypedResource : public Resource
+		{
+			explicit TypedResource(T* resource)
+				: resource(resource)
+			{
+			}
+
+			virtual Ptr clone(void*& data) const
+			{
+				return copy<T>(data);
+			}
+
+			template <typename U>
+			typename std::enable_if<std::is_copy_constructible<U>::value, Ptr>::type copy(void*& data) const
+			{
+				U* copied = new U(*resource);
+				data = copied;
+				return Ptr(new TypedResource<U>(copied));
+			}
+
+			template <typename U>
+			typename std::enable_if<!std::is_copy_constructible<U>::value, Ptr>::type copy(void*&) const
+			{
+				return nullptr;
+			}
+
+			std::unique_ptr<T>      resource;
+		};
+
+		template <typename T>
+		/** Index of a resource type plus one, zero initialized before any code runs */
+		struct Cache
+		{
+			static std::atomic<unsigned int> index;
+		};
+
+		/** A resource and a pointer to its data, so access needs no virtual call */
+		struct Slot
+		{
+			Resource::Ptr           resource;
+			void*                   data;
+		};
+
+		/** Assigns the index of a resource type */
+		static unsigned int getIndex(const std::type_index& type);
+
+		void setSlot(unsigned int index, Resource::Ptr resource, void* data);
+
+	private:
+		/** Resources indexed by resource type */
+		std::vector<Slot>           mSlots;
+	};
+
+	template <typename T>
+	std::atomic<unsigned int> ResourceManager::Cache<T>::index;
+}
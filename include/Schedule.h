@@ -0,0 +1,131 @@
+#pragma once
+#include "Entity.h"
+
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <vector>
+
+namespace Atlas
+{
+	/**
+	* A range of Entity::IDs within the Entity list of a System, for use in range based for loops.
+	*/
+	class EntityRange
+	{
+	public:
+		/**
+		* Creates a new EntityRange.
+		* @param begin - the first Entity::ID
+		* @param end - one past the last Entity::ID
+		*/
+		EntityRange(const Entity::ID* begin, const Entity::ID* end);
+
+		/** Retrieves the first Entity::ID */
+		const Entity::ID* begin() const;
+
+		/** Retrieves one past the last Entity::ID */
+		const Entity::ID* end() const;
+
+		/** Retrieves the number of Entity::IDs in the range */
+		std::size_t size() const;
+
+	private:
+		const Entity::ID*               mBegin;
+		const Entity::ID*               mEnd;
+	};
+
+	/**
+	* Timing figures of a System, kept by the SystemManager.
+	*/
+	struct ScheduleStats
+	{
+		/** Default Constructor */
+		ScheduleStats();
+
+		/** Number of calls to System::update() */
+		unsigned long long              runs;
+
+		/** Number of calls that took longer than the budget of the System */
+		unsigned long long              overruns;
+
+		/** Number of fixed steps that were dropped because the System fell too far behind */
+		unsigned long long              droppedSteps;
+
+		/** Duration of the last call, in microseconds */
+		double                          lastMicroseconds;
+
+		/** Duration of the longest call, in microseconds */
+		double                          maxMicroseconds;
+	};
+
+	/**
+	* How often the SystemManager updates a System.
+	* Set through System::setUpdateRate(), System::setFixedTimestep() and System::setTimeSliced().
+	*/
+	struct Schedule
+	{
+		typedef std::chrono::steady_clock Clock;
+
+		enum Mode
+		{
+			EVERY_FRAME,    // update once per World::update() with the frame time
+			RATE,           // update at a lower frequency with the time since the last update
+			FIXED_STEP      // update zero or more times per frame with a constant time step
+		};
+
+		/** Default Constructor, updates every frame */
+		Schedule();
+
+		Mode                            mode;
+
+		/** Time between updates for RATE and FIXED_STEP */
+		float                           interval;
+
+		/** Most fixed steps taken in a single frame */
+		unsigned int                    maxSteps;
+
+		/** Number of parts the Entities of a RATE System are split into, one part per update */
+		unsigned int                    slices;
+
+		/** Time an update may take before it counts as an overrun, in microseconds, 0 for none */
+		double                          budget;
+
+		/** Time not yet consumed by updates */
+		float                           accumulator;
+
+		/** The part of the Entities processed by the current update */
+		unsigned int                    slice;
+
+		/** Time since each part was last processed */
+		std::vector<float>              sliceElapsed;
+
+		/** Whether updates stop at the time slice and resume on the next update, see System::setTimeSliced() */
+		bool                            isTimeSliced;
+
+		/** Time a time sliced update may spend on Entities, in microseconds */
+		double                          timeSlice;
+
+		/** Copy of the Entity list taken when a time sliced pass starts */
+		std::vector<Entity::ID>         pass;
+
+		/** Next position in pass to be processed */
+		std::size_t                     cursor;
+
+		/** Entities processed by the current update */
+		std::size_t                     processed;
+
+		/** Time at which the current update started and runs out of its time slice */
+		Clock::time_point               start;
+		Clock::time_point               deadline;
+
+		/** Whether updates run as tasks on another thread, see System::setAsync() */
+		bool                            isAsync;
+
+		/** The update in flight, valid until it is collected on the main thread */
+		std::future<void>               task;
+
+		/** Frame time that passed while the task was in flight, given to the next update */
+		float                           waited;
+	};
+}
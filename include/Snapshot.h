@@ -0,0 +1,423 @@
+#pragma once
+#include "Component.h"
+#include "Bitsize.h"
+#include "FieldManager.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <vector>
+
+namespace Atlas
+{
+	class World;
+	class ComponentIdentifier;
+
+	/**
+	* Appends binary data to a snapshot buffer.
+	* Values are written in host byte order.
+	*/
+	class SnapshotWriter
+	{
+	public:
+		/**
+		* Creates a writer that appends to a buffer.
+		* @param buffer - the buffer to append to
+		*/
+		explicit SnapshotWriter(std::vector<char>& buffer);
+
+		/**
+		* Appends raw bytes.
+		* @param data - the bytes to be written
+		* @param size - the number of bytes
+		*/
+		void write(const void* data, std::size_t size);
+
+		/**
+		* Appends a 32 bit unsigned value.
+		* @param value - the value to be written
+		*/
+		void writeUInt(std::uint32_t value);
+
+		/**
+		* Appends a length prefixed string.
+		* @param value - the string to be written
+		*/
+		void writeString(const std::string& value);
+
+		/**
+		* Appends a count prefixed array of 32 bit values, aligned to Snapshot::ALIGNMENT.
+		* @param values - the values to be written
+		* @param count - the number of values
+		*/
+		void writeArray(const std::uint32_t* values, std::size_t count);
+
+		/**
+		* Reserves space at the end of the buffer.
+		* @param size - the number of bytes to reserve
+		* @return Offset of the reserved space in the buffer
+		*/
+		std::size_t reserve(std::size_t size);
+
+		/**
+		* Pads the buffer with zeros up to a multiple of an alignment.
+		* @param alignment - the alignment in bytes
+		*/
+		void align(std::size_t alignment);
+
+		/**
+		* Retrieves the buffer being written.
+		*/
+		std::vector<char>& getBuffer();
+
+	private:
+		std::vector<char>&          mBuffer;
+	};
+
+	/**
+	* Reads binary data from a snapshot buffer.
+	* Reads past the end of the buffer fail and mark the reader as invalid.
+	*/
+	class SnapshotReader
+	{
+	public:
+		/**
+		* Creates a reader over a block of memory.
+		* @param data - start of the snapshot data
+		* @param size - size of the snapshot data in bytes
+		*/
+		SnapshotReader(const char* data, std::size_t size);
+
+		/**
+		* Copies raw bytes out of the snapshot.
+		* @param data - destination of the bytes
+		* @param size - the number of bytes
+		* @return True if the bytes were available
+		*/
+		bool read(void* data, std::size_t size);
+
+		/**
+		* Reads a 32 bit unsigned value.
+		* @return The value, or 0 if the read failed
+		*/
+		std::uint32_t readUInt();
+
+		/**
+		* Reads a length prefixed string.
+		* @return The string, or an empty string if the read failed
+		*/
+		std::string readString();
+
+		/**
+		* Reads a count prefixed array of strictly ascending values below a limit, in place.
+		* @param limit - every value must be below the limit
+		* @param count - receives the number of values
+		* @return Pointer to the values, or nullptr if the array was not available or invalid
+		*/
+		const std::uint32_t* readArray(std::uint32_t limit, std::size_t& count);
+
+		/**
+		* Skips bytes without reading them.
+		* @param size - the number of bytes to skip
+		* @return Pointer to the skipped bytes, or nullptr if they were not available
+		*/
+		const char* skip(std::size_t size);
+
+		/**
+		* Skips padding up to a multiple of an alignment, measured from the start of the data.
+		* @param alignment - the alignment in bytes
+		*/
+		void align(std::size_t alignment);
+
+		/**
+		* Checks if every read so far has succeeded.
+		*/
+		bool isValid() const;
+
+	private:
+		const char*                 mData;
+		std::size_t                 mSize;
+		std::size_t                 mOffset;
+		bool                        mIsValid;
+	};
+
+	/**
+	* A Component block inside snapshot data.
+	* Entity IDs and plain data entries are aligned arrays that can be read in place.
+	*/
+	struct SnapshotBlock
+	{
+		/** Name of the Component type */
+		std::string                 name;
+
+		/** Bytes per entry for plain data types, 0 for size prefixed hook entries */
+		std::size_t                 dataSize;
+
+		/** Number of Entities that own the Component */
+		std::size_t                 count;
+
+		/** Entity::IDs of the owners, in ascending order */
+		const std::uint32_t*        owners;
+
+		/** Start of the entries */
+		const char*                 data;
+
+		/** Size of the entries in bytes */
+		std::size_t                 size;
+	};
+
+	/**
+	* A group inside snapshot data.
+	*/
+	struct SnapshotGroup
+	{
+		std::string                 name;
+		std::size_t                 count;
+		const std::uint32_t*        members;
+	};
+
+	/**
+	* Layout of snapshot data, with pointers into the data itself.
+	* Created by Snapshot::parse().
+	*/
+	struct SnapshotContents
+	{
+		/** The next new Entity::ID of the saved World */
+		std::uint32_t               nextID;
+
+		/** Number of active Entities */
+		std::size_t                 entityCount;
+
+		/** Active Entity::IDs, in ascending order */
+		const std::uint32_t*        entities;
+
+		std::vector<SnapshotBlock>  blocks;
+		std::vector<SnapshotGroup>  groups;
+	};
+
+	/**
+	* Saves and restores the state of a World as a versioned binary snapshot.
+	*
+	* A snapshot holds the active and dead Entity IDs, one block per Component type and the groups.
+	* Every ID below the next new ID is listed, so a load never creates more Entities than the
+	* size of the data accounts for.
+	* Only Component types that have been registered are saved. Systems are not saved;
+	* they receive the loaded Entities through checkInterest.
+	*
+	* Usage Example:
+	~~~~~~~~~~~~~~~~~~
+	* Atlas::Snapshot::registerComponent<PositionComponent>();
+	* std::vector<char> data = world.saveSnapshot();
+	* otherWorld.loadSnapshot(data);
+	~~~~~~~~~~~~~~~~~~
+	*/
+	class Snapshot
+	{
+	public:
+		/** Writes a Component to a snapshot */
+		typedef void(*SaveFunction)(const Component& component, SnapshotWriter& writer);
+
+		/** Creates a Component from snapshot data */
+		typedef Component::Ptr(*LoadFunction)(SnapshotReader& reader);
+
+		/** Snapshot layout version written by save() and accepted by load() */
+		static const std::uint32_t VERSION = 3;
+
+		/** Alignment of the Entity::ID arrays and plain data entries in a snapshot */
+		static const std::size_t ALIGNMENT = 16;
+
+		template <typename T>
+		/**
+		* Registers a Component type whose members are plain data.
+		* The members are copied as raw bytes, so they must not hold pointers or
+		* owning types such as std::string. T must be default constructible and derive
+		* only from Atlas::Component, so its members directly follow the Component base.
+		* For a FieldComponent, the fields of each Entity are saved from the FieldManager.
+		*
+		* Usage Example:
+		~~~~~~~~~~~~~~~~~~
+		* Atlas::Snapshot::registerComponent<PositionComponent>();
+		~~~~~~~~~~~~~~~~~~
+		*/
+		static void registerComponent()
+		{
+			static_assert(std::is_base_of<Component, T>::value, "T must derive from Atlas::Component");
+			static_assert(std::is_default_constructible<T>::value, "T must be default constructible");
+			static_assert(sizeof(T) >= sizeof(Component), "T must derive from Atlas::Component");
+
+			registerPlainData<T>(static_cast<const T*>(nullptr));
+		}
+
+		template <typename T>
+		/**
+		* Registers a Component type with custom save and load hooks.
+		*
+		* Usage Example:
+		~~~~~~~~~~~~~~~~~~
+		* Atlas::Snapshot::registerComponent<NameComponent>(&saveName, &loadName);
+		~~~~~~~~~~~~~~~~~~
+		* @param save - writes the Component data
+		* @param load - creates a Component from the data written by save
+		*/
+		static void registerComponent(SaveFunction save, LoadFunction load)
+		{
+			static_assert(std::is_base_of<Component, T>::value, "T must derive from Atlas::Component");
+			assert(save != nullptr && load != nullptr);
+
+			registerType(typeid(T), sizeof(T), 0, nullptr, save, load, nullptr, nullptr);
+		}
+
+		/**
+		* Writes the state of a World to a buffer.
+		* @param world - the World to be saved
+		* @return The snapshot data
+		*/
+		static std::vector<char> save(World& world);
+
+		/**
+		* Replaces the state of a World with a snapshot. All existing Entities are destroyed.
+		* @param world - the World to be restored
+		* @param data - start of the snapshot data
+		* @param size - size of the snapshot data in bytes
+		* @return True if the snapshot was valid and loaded
+		*/
+		static bool load(World& world, const char* data, std::size_t size);
+
+		/**
+		* Replaces the state of a World with a snapshot that was already parsed, such as
+		* a MappedSnapshot. All existing Entities are destroyed.
+		* @param world - the World to be restored
+		* @param contents - layout created by parse(), the data it points into must still be valid
+		* @return True if the snapshot was loaded
+		*/
+		static bool load(World& world, const SnapshotContents& contents);
+
+		/**
+		* Reads the layout of snapshot data and checks that it is valid.
+		* No data is copied; the contents point into the snapshot.
+		* @param data - start of the snapshot data, aligned to ALIGNMENT
+		* @param size - size of the snapshot data in bytes
+		* @param contents - receives the layout
+		* @return True if the snapshot is valid
+		*/
+		static bool parse(const char* data, std::size_t size, SnapshotContents& contents);
+
+		/**
+		* Writes the state of a World to a file.
+		* @param world - the World to be saved
+		* @param path - the file to write
+		* @return True if the file was written
+		*/
+		static bool saveToFile(World& world, const std::string& path);
+
+		/**
+		* Replaces the state of a World with a snapshot file.
+		* @param world - the World to be restored
+		* @param path - the file to read
+		* @return True if the file was valid and loaded
+		*/
+		static bool loadFromFile(World& world, const std::string& path);
+
+	private:
+		friend class SnapshotDelta;  // Shares the registered serializers
+
+		Snapshot() = default;	// Not meant for instantiation
+
+		/** Creates a default constructed Component for the plain data path */
+		typedef Component*(*CreateFunction)();
+
+		/** Copies the fields of an Entity between the FieldManager and a plain data entry */
+		typedef void(*SaveFieldsFunction)(FieldManager& fManager, Entity::ID id, char* data);
+		typedef void(*LoadFieldsFunction)(FieldManager& fManager, Entity::ID id, const char* data);
+
+		/** Save and load hooks for a Component type */
+		struct Serializer
+		{
+			const ComponentIdentifier* identifier;
+			std::string             name;
+			std::size_t             dataSize;
+			CreateFunction          create;
+			SaveFunction            save;
+			LoadFunction            load;
+
+			/** Set for FieldComponent types, whose entries hold the fields of the Entity */
+			SaveFieldsFunction      saveFields;
+			LoadFieldsFunction      loadFields;
+		};
+
+		template <typename T>
+		static Component* createComponent()
+		{
+			return new T();
+		}
+
+		template <typename T>
+		/** Registers a plain data type whose members are copied */
+		static void registerPlainData(const Component*)
+		{
+			registerType(typeid(T), sizeof(T), sizeof(T) - sizeof(Component), &createComponent<T>, nullptr, nullptr, nullptr, nullptr);
+		}
+
+		template <typename T, typename F, std::size_t FIELDS>
+		/** Registers a FieldComponent type, the Component has no members and its fields are copied */
+		static void registerPlainData(const FieldComponent<F, FIELDS>*)
+		{
+			registerType(typeid(T), sizeof(T), sizeof(F) * FIELDS, &createComponent<T>, nullptr, nullptr, &saveFields<T>, &loadFields<T>);
+		}
+
+		template <typename T>
+		static void saveFields(FieldManager& fManager, Entity::ID id, char* data)
+		{
+			for (std::size_t field = 0; field < T::FIELD_COUNT; field++)
+				std::memcpy(data + field * sizeof(typename T::FieldType), &fManager.get<T>(id, field), sizeof(typename T::FieldType));
+		}
+
+		template <typename T>
+		static void loadFields(FieldManager& fManager, Entity::ID id, const char* data)
+		{
+			for (std::size_t field = 0; field < T::FIELD_COUNT; field++)
+				std::memcpy(&fManager.get<T>(id, field), data + field * sizeof(typename T::FieldType), sizeof(typename T::FieldType));
+		}
+
+		/**
+		* Adds a Component type to the registry.
+		* @param index - type_index for the Component
+		* @param size - sizeof the Component type
+		* @param dataSize - bytes copied for plain data types, 0 when hooks are used
+		* @param create - factory for plain data types
+		* @param save - save hook, or nullptr
+		* @param load - load hook, or nullptr
+		* @param saveFields - copies the fields of a FieldComponent type out, or nullptr
+		* @param loadFields - copies the fields of a FieldComponent type in, or nullptr
+		*/
+		static void registerType(const std::type_index& index, std::size_t size, std::size_t dataSize,
+			CreateFunction create, SaveFunction save, LoadFunction load, SaveFieldsFunction saveFields, LoadFieldsFunction loadFields);
+
+		/**
+		* Creates a Component from the next entry of a block.
+		* The fields of a FieldComponent type are written to the FieldManager.
+		* @param serializer - the registered type of the block
+		* @param fManager - the FieldManager of the World being loaded
+		* @param id - the Entity the Component is for
+		* @param source - the next plain data entry, advanced past it
+		* @param entries - reader over size prefixed hook entries
+		* @return The Component, or nullptr if the load hook failed
+		*/
+		static Component::Ptr readComponent(const Serializer& serializer, FieldManager& fManager, Entity::ID id,
+			const char*& source, SnapshotReader& entries);
+
+		/**
+		* Finds a registered Component type by name.
+		* @param name - the name written to the snapshot
+		* @return ComponentIdentifier ID of the type, or BITSIZE if it is not registered
+		*/
+		static unsigned int findType(const std::string& name);
+
+		/** Registered serializers indexed by ComponentIdentifier ID */
+		static std::vector<Serializer>      mSerializers;
+	};
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include "Snapshot.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Atlas
+{
+	class World;
+
+	/**
+	* Binary differences between two snapshots of a World, for replication and rollback.
+	*
+	* A delta lists the Entities that were destroyed and created, and for each Component
+	* type the Entities that lost, gained or changed the Component. Changed plain data
+	* entries are stored as the XOR of the old and new bytes with runs of unchanged bytes
+	* collapsed, so a Component that changed in a few members costs a few bytes.
+	* Changed hook entries are stored whole. Groups whose members changed are stored whole.
+	*
+	* A delta is applied to a World that is in the state of the older snapshot, and leaves
+	* it in the state of the newer one. Component types are matched by name, as in Snapshot.
+	* The delta holds checksums of the Entities, groups and each Component type of the older
+	* snapshot, which are compared to a snapshot of the World before it is patched.
+	*
+	* Usage Example:
+	~~~~~~~~~~~~~~~~~~
+	* std::vector<char> previous = world.saveSnapshot();
+	* world.update(dt);
+	* std::vector<char> current = world.saveSnapshot();
+	*
+	* std::vector<char> delta = Atlas::SnapshotDelta::create(previous, current);
+	* replica.applyDelta(delta);
+	~~~~~~~~~~~~~~~~~~
+	*/
+	class SnapshotDelta
+	{
+	public:
+		/** Delta layout version written by create() and accepted by apply() */
+		static const std::uint32_t VERSION = 2;
+
+		/**
+		* Creates the delta between two snapshots.
+		* @param from - the older snapshot
+		* @param to - the newer snapshot
+		* @return The delta data, or an empty buffer if either snapshot is invalid
+		*/
+		static std::vector<char> create(const std::vector<char>& from, const std::vector<char>& to);
+
+		/**
+		* Creates the delta between two snapshots.
+		* @param fromData - start of the older snapshot
+		* @param fromSize - size of the older snapshot in bytes
+		* @param toData - start of the newer snapshot
+		* @param toSize - size of the newer snapshot in bytes
+		* @return The delta data, or an empty buffer if either snapshot is invalid
+		*/
+		static std::vector<char> create(const char* fromData, std::size_t fromSize, const char* toData, std::size_t toSize);
+
+		/**
+		* Patches a World from the state of the older snapshot to the state of the newer one.
+		* The delta is checked against the World before anything is changed, which saves a
+		* snapshot of the World. Entities that were set inactive must be removed with
+		* World::update() first.
+		* @param world - the World to be patched
+		* @param data - start of the delta data
+		* @param size - size of the delta data in bytes
+		* @return True if the delta was valid for the World and applied
+		*/
+		static bool apply(World& world, const char* data, std::size_t size);
+
+	private:
+		SnapshotDelta() = default;	// Not meant for instantiation
+
+		/** Changes to a single Component type */
+		struct Block
+		{
+			std::string             name;
+			std::size_t             dataSize;
+
+			std::size_t             removedCount;
+			const std::uint32_t*    removed;
+
+			std::size_t             addedCount;
+			const std::uint32_t*    added;
+			const char*             addedData;
+			std::size_t             addedSize;
+
+			std::size_t             changedCount;
+			const std::uint32_t*    changed;
+			const char*             changedData;
+			std::size_t             changedSize;
+		};
+
+		/** Checksum of a Component type in the older snapshot */
+		struct BaseBlock
+		{
+			std::string             name;
+			std::size_t             dataSize;
+			std::uint32_t           checksum;
+		};
+
+		/** Layout of delta data, with pointers into the data itself */
+		struct Contents
+		{
+			std::uint32_t           baseNextID;
+			std::uint32_t           baseCount;
+			std::uint32_t           baseChecksum;
+			std::uint32_t           nextID;
+
+			std::size_t             destroyedCount;
+			const std::uint32_t*    destroyed;
+
+			std::size_t             createdCount;
+			const std::uint32_t*    created;
+
+			std::vector<BaseBlock>      baseBlocks;
+			std::vector<Block>          blocks;
+			std::vector<SnapshotGroup>  groups;
+		};
+
+		/**
+		* Reads the layout of delta data and checks that it is well formed.
+		* @param data - start of the delta data
+		* @param size - size of the delta data in bytes
+		* @param contents - receives the layout
+		* @return True if the delta is well formed
+		*/
+		static bool parse(const char* data, std::size_t size, Contents& contents);
+
+		/**
+		* Checks that a delta can be applied to a World without changing it.
+		* @param world - the World to be patched
+		* @param contents - the parsed delta
+		* @param types - receives the registered Component ID for each block, or BITSIZE
+		* @return True if the World matches the checksums of the state the delta was created from
+		*/
+		static bool check(World& world, const Contents& contents, std::vector<unsigned int>& types);
+	};
+}
@@ -0,0 +1,273 @@
+#pragma once
+#include "System.h"
+#include "World.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Atlas
+{
+	/** A position on the plane indexed by a SpatialGrid */
+	struct Point
+	{
+		float x;
+		float y;
+	};
+
+	/** An axis aligned box on the plane, min and max inclusive */
+	struct Bounds
+	{
+		Point min;
+		Point max;
+	};
+
+	/** A circle on the plane */
+	struct Circle
+	{
+		Point center;
+		float radius;
+	};
+
+	/**
+	* Results of a batch of spatial queries.
+	* The Entities found by each query are stored back to back in a single container.
+	*/
+	struct SpatialResults
+	{
+		/**
+		* Retrieves the number of queries in the batch.
+		*/
+		std::size_t size() const;
+
+		/**
+		* Retrieves the number of Entities found by a query.
+		* @param query - index of the query in the batch
+		*/
+		std::size_t count(std::size_t query) const;
+
+		/**
+		* Retrieves the Entities found by a query.
+		* @param query - index of the query in the batch
+		* @return Pointer to the first of count(query) Entity::IDs
+		*/
+		const Entity::ID* get(std::size_t query) const;
+
+		/** Entity::IDs found by every query */
+		std::vector<Entity::ID>     entities;
+
+		/** Start of each query in entities, followed by the end of the last query */
+		std::vector<std::size_t>    offsets;
+	};
+
+	/**
+	* Base class for Systems that index their Entities in a uniform grid for range queries.
+	*
+	* Entities enter and leave the grid through the System interest mechanism. By default
+	* each update polls the position of every Entity, which costs O(n) per frame however few
+	* Entities moved, and only moves the Entities that changed cells. With polling turned
+	* off, the Systems that move Entities report them through moved() and each update only
+	* reads the reported Entities.
+	* Positions are kept with the grid cells, so queries do not read any Components.
+	* Queries see positions as of the last update, so add the System after the Systems
+	* that move Entities.
+	*
+	* Derived classes provide the position of an Entity. SpatialIndex does so for a
+	* Component type.
+	*/
+	class SpatialGrid : public System
+	{
+	public:
+		/**
+		* Moves every Entity whose position changed to its new cell. Reads the position
+		* of every Entity when polling, otherwise only of the Entities passed to moved().
+		* @param dt - update time
+		*/
+		virtual void update(float dt);
+
+		/**
+		* Reports an Entity whose position changed, so the next update reads it.
+		* Only needed with polling turned off. Call on the main thread.
+		* @param id - ID of the Entity
+		*/
+		void moved(Entity::ID id);
+
+		/**
+		* Sets whether each update reads the position of every Entity. On by default.
+		* Turn it off when every System that changes positions calls moved().
+		* @param isPolling - true to read every position each update
+		*/
+		void setPolling(bool isPolling);
+
+		/**
+		* Finds the Entities within a distance of a point.
+		* @param center - center of the query
+		* @param radius - maximum distance from the center
+		* @param results - the found Entity::IDs are added to the end
+		*/
+		void queryRadius(const Point& center, float radius, std::vector<Entity::ID>& results) const;
+
+		/**
+		* Finds the Entities within each of a batch of circles.
+		* @param circles - the queries
+		* @param results - replaced with the Entities found by each query
+		*/
+		void queryRadius(const std::vector<Circle>& circles, SpatialResults& results) const;
+
+		/**
+		* Finds the Entities within a box.
+		* @param bounds - the box
+		* @param results - the found Entity::IDs are added to the end
+		*/
+		void queryBounds(const Bounds& bounds, std::vector<Entity::ID>& results) const;
+
+		/**
+		* Finds the Entities within each of a batch of boxes.
+		* @param bounds - the queries
+		* @param results - replaced with the Entities found by each query
+		*/
+		void queryBounds(const std::vector<Bounds>& bounds, SpatialResults& results) const;
+
+		/**
+		* Finds the Entity closest to a point.
+		* @param point - the point of interest
+		* @param maxRadius - maximum distance to search
+		* @param nearest - receives the closest Entity
+		* @return True if an Entity was found within maxRadius
+		*/
+		bool findNearest(const Point& point, float maxRadius, Entity::ID& nearest) const;
+
+		/**
+		* Retrieves the size of a grid cell.
+		*/
+		float getCellSize() const;
+
+	protected:
+		/**
+		* Creates a new SpatialGrid.
+		* Cells should be about the size of a typical query.
+		* @param world - the World object that owns this System
+		* @param cellSize - width and height of a grid cell
+		*/
+		SpatialGrid(World& world, float cellSize);
+
+		/**
+		* Retrieves the current position of an Entity in the System.
+		* @param id - ID of the Entity
+		*/
+		virtual Point getPosition(Entity::ID id) const = 0;
+
+		virtual void entityAdded(Entity& entity);
+		virtual void entityRemoved(Entity& entity);
+		virtual void entitiesRemapped(const std::vector<Entity::Relocation>& relocations);
+		virtual void entitiesReplaced();
+
+	private:
+		/** An Entity and its position, as stored in a cell */
+		struct Entry
+		{
+			Entity::ID              id;
+			Point                   position;
+		};
+
+		/** Location of an Entity in the grid */
+		struct Slot
+		{
+			std::uint64_t           cell;
+			std::uint32_t           index;
+			bool                    isIndexed;
+			bool                    isMoved;
+		};
+
+		typedef std::vector<Entry> Cell;
+
+		/**
+		* Adds an Entity to the grid, or moves it if it is already there.
+		* @param id - ID of the Entity
+		* @param position - position of the Entity
+		*/
+		void place(Entity::ID id, const Point& position);
+
+		/**
+		* Removes an Entity from its cell.
+		* @param id - ID of the Entity
+		*/
+		void erase(Entity::ID id);
+
+		template <typename Visit>
+		/**
+		* Calls a function with every Entry in the cells that overlap a box.
+		* @param bounds - the box
+		* @param visit - called with each Entry
+		*/
+		void forEachEntry(const Bounds& bounds, Visit visit) const;
+
+		/**
+		* Retrieves the cell coordinate of a position along one axis.
+		*/
+		std::int32_t toCell(float value) const;
+
+		/**
+		* Packs cell coordinates into a cell key.
+		*/
+		static std::uint64_t toKey(std::int32_t x, std::int32_t y);
+
+	private:
+		float                                   mCellSize;
+		float                                   mInverseCellSize;
+
+		/** Cells that hold at least one Entity */
+		std::unordered_map<std::uint64_t, Cell> mCells;
+
+		/** Cell and index in the cell of each Entity, indexed by Entity::ID */
+		std::vector<Slot>                       mSlots;
+
+		/** Entities reported through moved() since the last update */
+		std::vector<Entity::ID>                 mMoved;
+
+		bool                                    mIsPolling;
+	};
+
+	template <typename T>
+	/**
+	* A SpatialGrid that indexes Entities by a position Component.
+	* 3D positions are indexed by projecting them onto a plane in the position function.
+	*
+	* Usage Example:
+	~~~~~~~~~~~~~~~~~~
+	* Atlas::Point getPoint(const PositionComponent& p) { Atlas::Point point = { p.x, p.z }; return point; }
+	*
+	* world.getSystemManager().addSystem(Atlas::System::Ptr(new Atlas::SpatialIndex<PositionComponent>(world, 10.0f, &getPoint)));
+	* world.getSystemManager().getSystem<Atlas::SpatialIndex<PositionComponent>>()->queryRadius(center, 25.0f, nearby);
+	~~~~~~~~~~~~~~~~~~
+	*/
+	class SpatialIndex : public SpatialGrid
+	{
+	public:
+		/** Reads the position from a Component */
+		typedef Point(*PositionFunction)(const T&);
+
+		/**
+		* Creates a new SpatialIndex.
+		* @param world - the World object that owns this System
+		* @param cellSize - width and height of a grid cell
+		* @param position - reads the position from a Component
+		*/
+		SpatialIndex(World& world, float cellSize, PositionFunction position)
+			: SpatialGrid(world, cellSize)
+			, mPosition(position)
+		{
+			addComponentType<T>();
+		}
+
+	protected:
+		virtual Point getPosition(Entity::ID id) const
+		{
+			return mPosition(*getWorld().getEntityManager().readComponentFor<T>(id));
+		}
+
+	private:
+		PositionFunction                        mPosition;
+	};
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include "Component.h"
+#include "ComponentIdentifier.h"
+#include "Entity.h"
+
+#include <vector>
+
+namespace Atlas
+{
+	class EntityManager;
+
+	/**
+	* Creates Entities and adds Components from a worker thread.
+	*
+	* Each worker job owns a SpawnBuffer. createEntity() hands out an Entity::ID right away
+	* from a block of IDs the buffer reserved with a single atomic operation, so the ID can
+	* be stored or passed on. Components are staged in one shard per Component type, for
+	* new Entities or for Entities that already exist. When the buffer is committed on the
+	* main thread, at a point where no System is running, each shard is merged into its
+	* Component table in one pass.
+	*
+	* Only the block reservation touches shared state. The EntityManager must not be
+	* cloned or loaded while a buffer holds uncommitted Entities. Shrinking is skipped and
+	* defragmenting keeps every free ID pooled until all buffers are committed.
+	*
+	* Usage Example:
+	~~~~~~~~~~~~~~~~~~
+	* // worker thread
+	* Atlas::Entity::ID id = buffer.createEntity();
+	* buffer.addComponent(id, Atlas::Component::Ptr(new ProjectileComponent()));
+	* buffer.addComponent(target, Atlas::Component::Ptr(new DamageComponent()));
+	*
+	* // main thread, after the workers are done
+	* world.getEntityManager().commit(buffer);
+	~~~~~~~~~~~~~~~~~~
+	*/
+	class SpawnBuffer : public NonCopyable
+	{
+	public:
+		/**
+		* Creates an empty SpawnBuffer.
+		* @param eManager - the EntityManager the Entities are created in
+		* @param blockSize - the number of IDs reserved at a time
+		*/
+		explicit SpawnBuffer(EntityManager& eManager, unsigned int blockSize = 64);
+
+		/** Destructor, the buffer must have been committed */
+		~SpawnBuffer();
+
+		/**
+		* Creates an Entity. Safe to call from any thread, one thread per buffer.
+		* @return ID of the Entity, valid once the buffer is committed
+		*/
+		Entity::ID createEntity();
+
+		/**
+		* Stages a Component for an Entity created through this buffer, or for an active
+		* Entity that stays active until the buffer is committed. A Component of a type the
+		* Entity already owns replaces it on commit.
+		* @param id - ID of the Entity
+		* @param component - Component to add
+		*/
+		void addComponent(Entity::ID id, Component::Ptr component);
+
+		/**
+		* Retrieves the number of Entities waiting to be committed.
+		*/
+		std::size_t size() const;
+
+	private:
+		friend class EntityManager;  // Commits the Entities and Components
+
+		/** Components of a single type staged by the buffer */
+		struct Shard
+		{
+			Shard();
+
+			const ComponentIdentifier*      identifier;
+			std::vector<Entity::ID>         owners;
+			std::vector<Component::Ptr>     components;
+		};
+
+		EntityManager&                  mEntityManager;
+		unsigned int                    mBlockSize;
+
+		/** Next ID in the reserved block and one past its end */
+		Entity::ID                      mNextID;
+		Entity::ID                      mBlockEnd;
+
+		/** Number of IDs reserved, used or not */
+		unsigned int                    mReserved;
+
+		std::vector<Entity::ID>         mEntities;
+
+		/** Staged Components, indexed by ComponentIdentifier ID */
+		std::vector<Shard>              mShards;
+	};
+}
@@ -2,10 +2,14 @@
 #include <memory>
 #include <vector>
 #include <bitset>
+#include <cassert>
 
 #include "Bitsize.h"
 #include "Entity.h"
 #include "ComponentIdentifierManager.h"
+#include "ResourceManager.h"
+#include "Query.h"
+#include "Schedule.h"
 
 namespace Atlas
 {
@@ -33,12 +37,18 @@ namespace Atlas
 
 		/**
 		* Checks to see if the System is interested in an Entity based on which
-		* Components it owns. This is called everytime an Entity removes or adds
-		* a Component. If the System is no longer interested in an Entity that
+		* Components it owns. If the System is no longer interested in an Entity that
 		* it already contains, the Entity will be removed from the System.
+		* The check is made on the shared Query of the System, so every System that
+		* shares the Query is updated. The QueryManager calls this for every Query
+		* each time an Entity removes or adds a Component.
+		*
+		* Systems react to Entities entering and leaving by overriding entityAdded() and
+		* entityRemoved(), which replace overriding this function. It is final so that a
+		* System which still overrides it fails to compile instead of never being called.
 		* @param Entity - the Entity to be checked
 		*/
-		virtual void checkInterest(Entity& Entity);
+		virtual void checkInterest(Entity& Entity) final;
 
 		/**
 		* Retrieves the system type bits that are assigned to this System.
@@ -46,6 +56,25 @@ namespace Atlas
 		*/
 		std::bitset<BITSIZE> getSystemBits() const;
 
+		/**
+		* Retrieves the timing figures of the System, including budget overruns.
+		* The time of an asynchronous update runs from its start to its completion.
+		*/
+		const ScheduleStats& getStats() const;
+
+		/**
+		* Checks if an asynchronous update is in flight or waiting to be collected.
+		*/
+		bool isRunning() const;
+
+		/**
+		* Waits for the asynchronous update in flight, if any, and collects it.
+		* Systems that depend on the results of an asynchronous System call this from
+		* their own update when they need them. Call on the main thread.
+		* An exception thrown by the update is rethrown here.
+		*/
+		void wait();
+
 		/**
 		* Prints Entities in the System, as well as this System's TypeBits and SystemBits
 		*/
@@ -63,9 +92,217 @@ namespace Atlas
 		*/
 		void addComponentType()
 		{
-			mTypeBits |= ComponentIdentifierManager::getBits<T>();
+			mSignature.required |= ComponentIdentifierManager::getBits<T>();
 		}
 
+		template <typename T>
+		/**
+		* Keeps Entities that own a Component type out of the System, even if they
+		* own every type added with addComponentType<>().
+		*
+		* Usage Example: (in MovementSystem constructor)
+		* ~~~~~~~~~~~~~~~~~~~~~
+		* addComponentType<PositionComponent>();
+		* exclude<FrozenComponent>();
+		* ~~~~~~~~~~~~~~~~~~~~~
+		*/
+		void exclude()
+		{
+			mSignature.excluded |= ComponentIdentifierManager::getBits<T>();
+		}
+
+		template <typename T>
+		/**
+		* Declares a Component type that the System reads when an Entity owns it.
+		* Optional types do not change which Entities the System processes.
+		*
+		* Usage Example: (in RenderSystem constructor)
+		* ~~~~~~~~~~~~~~~~~~~~~
+		* addComponentType<SpriteComponent>();
+		* optional<TintComponent>();
+		* ~~~~~~~~~~~~~~~~~~~~~
+		*/
+		void optional()
+		{
+			mSignature.optional |= ComponentIdentifierManager::getBits<T>();
+		}
+
+		template <typename T>
+		/**
+		* Checks if an Entity owns an optional Component type.
+		* @param id - ID of the Entity of interest
+		*/
+		bool hasOptional(Entity::ID id) const
+		{
+			assert((mSignature.optional & ComponentIdentifierManager::getBits<T>()).any() && "Type was not declared optional");
+			return ownsComponent(id, ComponentIdentifierManager::getID<T>());
+		}
+
+		template <typename T>
+		/**
+		* Declares a resource that the System reads in its update.
+		* An update never runs while an asynchronous update that writes the resource is in flight.
+		*
+		* Usage Example: (in MovementSystem constructor)
+		* ~~~~~~~~~~~~~~~~~~~~~
+		* readsResource<GameClock>();
+		* ~~~~~~~~~~~~~~~~~~~~~
+		*/
+		void readsResource()
+		{
+			mResourceReads |= ResourceManager::getBits<T>();
+		}
+
+		template <typename T>
+		/**
+		* Declares a resource that the System writes in its update.
+		* An update never runs while an asynchronous update that reads or writes the resource is in flight.
+		*/
+		void writesResource()
+		{
+			mResourceWrites |= ResourceManager::getBits<T>();
+		}
+
+		/**
+		* Makes the System process its Entities in the depth-first order of the HierarchyManager,
+		* so parents are processed before their children. Used for transform propagation.
+		* The Entity list is sorted again before an update whenever it or the hierarchy changed.
+		* @param enabled - true to process Entities in depth-first order
+		*/
+		void setDepthFirst(bool enabled);
+
+		/**
+		* Updates the System at a lower frequency than the frame rate, with the time since
+		* its last update. With more than one slice, the Entities are split into that many
+		* parts and one part is processed per update, so the work is spread across frames;
+		* each Entity is still processed at the given frequency. Systems that use slices
+		* iterate getEntityRange() instead of getEntities().
+		*
+		* Usage Example: (in AISystem constructor)
+		* ~~~~~~~~~~~~~~~~~~~~~
+		* setUpdateRate(10.0f, 6);
+		* ~~~~~~~~~~~~~~~~~~~~~
+		* @param frequency - updates per second for each Entity
+		* @param slices - the number of parts the Entities are split into
+		*/
+		void setUpdateRate(float frequency, unsigned int slices = 1);
+
+		/**
+		* Updates the System with a constant time step, as many times per frame as the
+		* elapsed time requires. If the System falls more than maxSteps behind, the
+		* remaining steps are dropped and counted in getStats().
+		* @param step - the time step passed to update()
+		* @param maxSteps - the most steps taken in a single frame
+		*/
+		void setFixedTimestep(float step, unsigned int maxSteps = 4);
+
+		/**
+		* Sets the time a single update may take. Updates that take longer are counted
+		* as overruns in getStats().
+		* @param microseconds - the budget, 0 for none
+		*/
+		void setBudget(double microseconds);
+
+		/**
+		* Makes the System process its Entities over as many updates as it takes to stay
+		* within a time slice. The System calls nextEntity() in its update, which stops
+		* once the slice is spent and resumes from the same place on the next update.
+		* The slice is separate from setBudget(), which only decides what counts as an overrun.
+		* A pass works from a copy of the Entity list taken when it starts, so Entities
+		* added during a pass are processed by the next pass and Entities removed during
+		* a pass are skipped.
+		*
+		* Usage Example: (in PathfindingSystem)
+		* ~~~~~~~~~~~~~~~~~~~~~
+		* setTimeSliced(500.0);
+		*
+		* Atlas::Entity::ID id;
+		* while (nextEntity(id))
+		*	findPath(id);
+		* ~~~~~~~~~~~~~~~~~~~~~
+		* @param microseconds - the time each update may spend
+		*/
+		void setTimeSliced(double microseconds);
+
+		/**
+		* Runs update() as a task on another thread, so a long update overlaps with the
+		* frames that follow instead of stalling them. The System is skipped every frame
+		* until its task completes, and the next update receives all of the time that
+		* passed. The task works on a copy of the Entity list taken when it starts, see
+		* getEntityRange().
+		*
+		* The World keeps changing while the task runs. The update should read data copied
+		* in taskStarting() and keep its results in the System until taskCompleted(), which
+		* both run on the main thread. Can not be combined with fixed timesteps or time slicing.
+		*
+		* Usage Example: (in StreamingSystem)
+		* ~~~~~~~~~~~~~~~~~~~~~
+		* setAsync(true);
+		*
+		* void StreamingSystem::update(float dt)
+		* {
+		*	for (const Atlas::Entity::ID& id : getEntityRange())
+		*		mLoaded.push_back(loadChunk(mRequests[id]));
+		* }
+		* ~~~~~~~~~~~~~~~~~~~~~
+		* @param enabled - true to run updates asynchronously
+		*/
+		void setAsync(bool enabled);
+
+		/**
+		* Retrieves the next Entity of a time sliced pass.
+		* The update stops before an Entity that is expected to run past the time slice, judged by
+		* the average time of the Entities processed so far. At least one Entity is returned
+		* per update, so a pass always makes progress.
+		* @param id - receives the ID of the next Entity
+		* @return False once the time slice is spent or the pass is complete
+		*/
+		bool nextEntity(Entity::ID& id);
+
+		/**
+		* Retrieves the Entities to be processed by the current update.
+		* This is every Entity unless the System uses slices, see setUpdateRate().
+		* Asynchronous Systems get the copy of the Entity list taken when the task started.
+		*/
+		EntityRange getEntityRange() const;
+
+		/**
+		* Called after an Entity was added to the System.
+		* @param entity - the added Entity
+		*/
+		virtual void entityAdded(Entity& entity);
+
+		/**
+		* Called after an Entity was removed from the System, which may be
+		* after the Components the System processes were removed.
+		* @param entity - the removed Entity
+		*/
+		virtual void entityRemoved(Entity& entity);
+
+		/**
+		* Called after the IDs of Entities in the System were changed by World::defragment().
+		* @param relocations - old and new IDs of the moved Entities
+		*/
+		virtual void entitiesRemapped(const std::vector<Entity::Relocation>& relocations);
+
+		/**
+		* Called after the Entity list of the System was replaced as a whole by World::clone(),
+		* once the Components of the new Entities are in place.
+		*/
+		virtual void entitiesReplaced();
+
+		/**
+		* Called on the main thread before an asynchronous update starts, to copy the data
+		* the task reads.
+		*/
+		virtual void taskStarting();
+
+		/**
+		* Called on the main thread after an asynchronous update completed, to apply its
+		* results to the World.
+		*/
+		virtual void taskCompleted();
+
 		/**
 		* Retrieves the Component bit types that the System will process.
 		* @return Bitset of Component types
@@ -73,7 +310,13 @@ namespace Atlas
 		std::bitset<BITSIZE> getTypeBits() const;
 
 		/**
-		* Retrieves the Entity::IDs of interested Entities
+		* Retrieves the required, excluded and optional Component types of the System.
+		*/
+		const Signature& getSignature() const;
+
+		/**
+		* Retrieves the Entity::IDs of interested Entities.
+		* The list is shared with other Systems that process the same Component types.
 		* @return Container of Entity::IDs
 		*/
 		const std::vector<Entity::ID>& getEntities() const;
@@ -85,12 +328,14 @@ namespace Atlas
 
 	private:
 		friend class SystemManager;  // Give full access to SystemManager
+		friend class QueryManager;   // Connects the System to its Query
+		friend class Query;          // Notifies the System of Entity changes
 
 		/**
-		* Removes an Entity from the System.
-		* @params Entity - the Entity to be removed
+		* Replaced by entityRemoved(), as Entities are removed by the shared Query of the System.
+		* Deleted so that a System which still overrides it fails to compile.
 		*/
-		virtual void remove(Entity& Entity);
+		virtual void remove(Entity& Entity) = delete;
 
 		/**
 		* Assigns a bitset for the System
@@ -98,10 +343,63 @@ namespace Atlas
 		*/
 		void setSystemBits(const std::bitset<BITSIZE>& Bit);
 
+		/**
+		* Starts a new time sliced pass if the last one is complete.
+		* Called by the SystemManager before each update.
+		*/
+		void beginPass();
+
+		/**
+		* Starts an asynchronous update with a copy of the Entity list.
+		* @param dt - update time passed to the System
+		*/
+		void startTask(float dt);
+
+		/**
+		* Waits for the asynchronous update in flight and records how long it took.
+		*/
+		void finishTask();
+
+		/**
+		* Adds an update to the timing figures.
+		* @param microseconds - the duration of the update
+		*/
+		void recordRun(double microseconds);
+
+		/**
+		* Replaces the IDs of relocated Entities in the current time sliced pass.
+		* @param relocations - old and new IDs of the moved Entities
+		*/
+		void remapPass(const std::vector<Entity::Relocation>& relocations);
+
+		/**
+		* Checks if an Entity owns a Component type.
+		* @param id - ID of the Entity of interest
+		* @param type - ID of the Component type
+		*/
+		bool ownsComponent(Entity::ID id, unsigned int type) const;
+
+		/**
+		* Checks if the System and another System use a resource that one of them writes.
+		* @param other - the System to compare with
+		*/
+		bool conflictsWith(const System& other) const;
+
 	private:
 		World&                          mWorld;
-		std::bitset<BITSIZE>            mTypeBits;
+		Signature                       mSignature;
 		std::bitset<BITSIZE>            mSystemBits;
-		std::vector<Entity::ID>         mEntities;
+
+		/** Resources used by update(), indexed by ResourceManager::getIndex<>() */
+		std::bitset<BITSIZE>            mResourceReads;
+		std::bitset<BITSIZE>            mResourceWrites;
+
+		/** Shared list of interested Entities, set once the System is added to a World */
+		Query*                          mQuery;
+		bool                            mIsDepthFirst;
+
+		/** Update frequency and its state, run by the SystemManager */
+		Schedule                        mSchedule;
+		ScheduleStats                   mStats;
 	};
 }
\ No newline at end of file
@@ -1,14 +1,16 @@
 #pragma once
 #include "NonCopyable.h"
 #include "Bitsize.h"
+#include "TypeRegistry.h"
 
-#include <unordered_map>
 #include <typeindex>
 
 namespace Atlas
 {
 	/**
 	* Used to distribute a unique bit identifier to each System created.
+	* Like the ComponentIdentifierManager, lookups do not lock and the registry can be frozen
+	* once every System type has been added.
 	*/
 	class SystemBitManager : public NonCopyable
 	{
@@ -41,11 +43,21 @@ namespace Atlas
 			return getBitsFor(typeid(*type));
 		}
 
+		/**
+		* Stops any further System types from being registered.
+		* Registering a new type afterwards is an error.
+		*/
+		static void freeze();
+
+		/**
+		* Checks if the registry has been frozen.
+		*/
+		static bool isFrozen();
 
 	private:
 		SystemBitManager() = default; 		//Not meant for instantiation
 
-		static std::bitset<BITSIZE>                                         mNextBit;
-		static std::unordered_map<std::type_index, std::bitset<BITSIZE>>    mSystemBitMap;
+		/** Map of Systems-to-bits */
+		static TypeRegistry<std::bitset<BITSIZE>>& getSystemBitMap();
 	};
 }
\ No newline at end of file
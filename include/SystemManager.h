@@ -1,5 +1,6 @@
 #pragma once
 #include "System.h"
+#include "MemoryReport.h"
 
 #include <vector>
 #include <memory>
@@ -20,6 +21,9 @@ namespace Atlas
 		*/
 		explicit SystemManager(World& world);
 
+		/** Destructor, waits for asynchronous updates in flight */
+		~SystemManager();
+
 		/**
 		* Adds a new System.
 		* Usage Example:
@@ -59,6 +63,8 @@ namespace Atlas
 		/**
 		* Updates all Systems.
 		* Update order is based on the order that Systems are added to the SystemManager.
+		* Systems with an update rate or fixed timestep are updated zero or more times,
+		* see System::setUpdateRate() and System::setFixedTimestep().
 		* @param dt - update time
 		*/
 		void update(float dt);
@@ -66,10 +72,17 @@ namespace Atlas
 		/**
 		* Checks to see if the any Systems contained in the SystemManager is interested 
 		* in an Entity based on which Components it owns.
+		* Each distinct set of Component types is only checked once, see QueryManager.
 		* @param entity - the Entity to be checked
 		*/
 		void checkInterest(Entity& entity);
 
+		/**
+		* Waits for the asynchronous update of every System and collects it.
+		* Called by the World before Entities are moved or replaced.
+		*/
+		void waitAll();
+
 		template <typename T>
 		/**
 		* Removes a System.
@@ -80,11 +93,33 @@ namespace Atlas
 		*/
 		void removeSystem();
 
+		/**
+		* Adds the memory held by the System table to a report.
+		* Entity lists are reported by the QueryManager.
+		* @param report - the report to be filled
+		*/
+		void reportMemory(MemoryReport& report) const;
+
 		/**
 		* Prints the number of active Systems and the details of each of those Systems
 		*/
 		void toString();
 
+	private:
+		/**
+		* Updates a single System and records how long it took.
+		* @param system - the System to be updated
+		* @param dt - update time passed to the System
+		*/
+		void run(System& system, float dt);
+
+		/**
+		* Waits for the asynchronous updates in flight that use a resource a System is about to
+		* use, when either of them writes it.
+		* @param system - the System about to be updated
+		*/
+		void waitForConflicts(System& system);
+
 	private:
 		World&                                              mWorld;
 		std::vector<System::Ptr>                            mSystems;
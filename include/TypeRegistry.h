@@ -0,0 +1,157 @@
+#pragma once
+#include "Bitsize.h"
+#include "NonCopyable.h"
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <typeindex>
+
+namespace Atlas
+{
+	template <typename T>
+	/**
+	* A registry that maps types to values, shared by every World.
+	*
+	* Entries are only ever added, never moved or removed, so lookups read the entries without
+	* locking. Adding an entry takes a lock and publishes the entry once it is complete.
+	* After freeze() is called no entries may be added, which guarantees that nothing in the
+	* registry changes while Worlds run on separate threads.
+	*/
+	class TypeRegistry : public NonCopyable
+	{
+	public:
+		/** Default Constructor */
+		TypeRegistry()
+			: mEntries()
+			, mCount(0)
+			, mMutex()
+			, mIsFrozen(false)
+		{
+		}
+
+		/**
+		* Retrieves a registry kept at namespace scope, creating it on the first call.
+		* Function-local statics are not initialized thread-safely by VS2013, so the registry
+		* is created through std::call_once. It is never destroyed, so it outlives every World.
+		*
+		* Usage Example:
+		~~~~~~~~~~~~~~~~~~
+		* std::once_flag flag;
+		* Atlas::TypeRegistry<unsigned int>* registry = nullptr;
+		*
+		* Atlas::TypeRegistry<unsigned int>& getRegistry()
+		* {
+		*	return Atlas::TypeRegistry<unsigned int>::getShared(flag, registry);
+		* }
+		~~~~~~~~~~~~~~~~~~
+		* @param flag - guards the creation, zero initialized at namespace scope
+		* @param registry - the registry, null until the first call
+		*/
+		static TypeRegistry& getShared(std::once_flag& flag, TypeRegistry*& registry)
+		{
+			std::call_once(flag, [&registry]() { registry = new TypeRegistry(); });
+			return *registry;
+		}
+
+		/**
+		* Finds the value for a type without locking.
+		* @param type - the type of interest
+		* @return Pointer to the value, or nullptr if the type has no entry
+		*/
+		T* find(const std::type_index& type) const
+		{
+			const std::size_t count = mCount.load(std::memory_order_acquire);
+
+			for (std::size_t i = 0; i < count; i++)
+				if (mEntries[i]->type == type)
+					return &mEntries[i]->value;
+
+			return nullptr;
+		}
+
+		template <typename Create>
+		/**
+		* Finds the value for a type, adding an entry if the type has none.
+		* @param type - the type of interest
+		* @param create - called with the index of the new entry to create its value
+		* @return Reference to the value
+		*/
+		T& findOrAdd(const std::type_index& type, Create create)
+		{
+			T* value = find(type);
+			if (value != nullptr)
+				return *value;
+
+			std::lock_guard<std::mutex> lock(mMutex);
+
+			// another thread may have added the type while we waited
+			value = find(type);
+			if (value != nullptr)
+				return *value;
+
+			assert(!isFrozen() && "Types must be registered before the registry is frozen");
+
+			const std::size_t index = mCount.load(std::memory_order_relaxed);
+			assert(index < BITSIZE && "Too many types registered, raise BITSIZE");
+
+			mEntries[index].reset(new Entry(type, create(index)));
+			mCount.store(index + 1, std::memory_order_release);
+
+			return mEntries[index]->value;
+		}
+
+		/**
+		* Retrieves the number of entries.
+		*/
+		std::size_t size() const
+		{
+			return mCount.load(std::memory_order_acquire);
+		}
+
+		/**
+		* Retrieves the value of an entry.
+		* @param index - index of the entry, below size()
+		*/
+		T& at(std::size_t index) const
+		{
+			assert(index < size());
+			return mEntries[index]->value;
+		}
+
+		/**
+		* Stops any further entries from being added.
+		*/
+		void freeze()
+		{
+			mIsFrozen.store(true, std::memory_order_release);
+		}
+
+		/**
+		* Checks if the registry has been frozen.
+		*/
+		bool isFrozen() const
+		{
+			return mIsFrozen.load(std::memory_order_acquire);
+		}
+
+	private:
+		struct Entry
+		{
+			Entry(const std::type_index& type, T value)
+				: type(type)
+				, value(std::move(value))
+			{
+			}
+
+			std::type_index         type;
+			T                       value;
+		};
+
+		std::unique_ptr<Entry>      mEntries[BITSIZE];
+		std::atomic<std::size_t>    mCount;
+		std::mutex                  mMutex;
+		std::atomic<bool>           mIsFrozen;
+	};
+}
@@ -1,12 +1,20 @@
 #pragma once
 #include "EntityManager.h"
 #include "SystemManager.h"
+#include "QueryManager.h"
 #include "GroupManager.h"
+#include "HierarchyManager.h"
+#include "FieldManager.h"
+#include "ObserverManager.h"
+#include "ResourceManager.h"
+#include "Profiler.h"
 
 #include <memory>
 
 namespace Atlas
 {
+	class MappedSnapshot;
+
 	/**
 	* Represents the game world
 	*/
@@ -19,7 +27,12 @@ namespace Atlas
 		World();
 
 		/**
-		* Updates the EntityManager and SystemManager.
+		* Destructor, waits for asynchronous System updates in flight.
+		*/
+		virtual ~World();
+
+		/**
+		* Updates the EntityManager, dispatches Component observers and updates the SystemManager.
 		* @param dt - update time
 		*/
 		virtual void update(float dt);
@@ -37,6 +50,83 @@ namespace Atlas
 		*/
 		Entity& getEntity(Entity::ID id) const;
 
+		/**
+		* Retrieves a breakdown of the memory held by Components, Entities, Systems and groups.
+		* @return the memory report
+		*/
+		MemoryReport memoryReport() const;
+
+		/**
+		* Retrieves the structural changes made since the last call: Components added and
+		* removed per type, Entities created and reaped, interest checks and their sampled
+		* latency. Call once per frame for per frame figures. Empty unless ATLAS_PROFILING is 1.
+		* @return the profile report
+		*/
+		ProfileReport profileReport();
+
+		/**
+		* Releases unused capacity held by the World's tables.
+		* Intended for loading screens or other points where a pause is acceptable.
+		*/
+		void shrinkToFit();
+
+		/**
+		* Packs active Entities into the lowest IDs, a few at a time.
+		* Call once per frame (or in a loop) until the returned list is empty,
+		* then shrinkToFit() can release the freed memory. System Entity lists
+		* are sorted by ID when a pass completes.
+		* @param maxMoves - the maximum number of Entities to move in this call
+		* @return old and new IDs of the Entities that were moved
+		*/
+		std::vector<Entity::Relocation> defragment(unsigned int maxMoves);
+
+		/**
+		* Writes the Entities, registered Components and groups to a binary snapshot.
+		* @return the snapshot data
+		* @see Snapshot
+		*/
+		std::vector<char> saveSnapshot();
+
+		/**
+		* Replaces all Entities, Components and groups with the contents of a snapshot.
+		* @param data - snapshot data created by saveSnapshot()
+		* @return True if the snapshot was valid and loaded
+		*/
+		bool loadSnapshot(const std::vector<char>& data);
+
+		/**
+		* Replaces all Entities, Components and groups with the contents of a mapped snapshot file.
+		* The snapshot is read in place; no copy of the file is made.
+		* @param snapshot - the mapped snapshot
+		* @return True if the snapshot was valid and loaded
+		*/
+		bool loadSnapshot(const MappedSnapshot& snapshot);
+
+		/**
+		* Patches the World with a delta between two snapshots.
+		* The World must be in the state of the older snapshot.
+		* @param delta - delta data created by SnapshotDelta::create()
+		* @return True if the delta was valid for the World and applied
+		* @see SnapshotDelta
+		*/
+		bool applyDelta(const std::vector<char>& delta);
+
+		/**
+		* Replaces the Entities, Components, groups and resources of another World with copies of this World,
+		* for prediction or lookahead. The other World keeps its Systems; add the same Systems to it
+		* once and it can be cloned into every frame.
+		*
+		* Usage Example:
+		~~~~~~~~~~~~~~~~~~
+		* world.clone(prediction, true);
+		* prediction.update(dt);
+		~~~~~~~~~~~~~~~~~~
+		* @param target - the World to copy into
+		* @param copyOnWrite - share Component tables until one of the Worlds writes to them
+		* @see EntityManager::cloneTo
+		*/
+		void clone(World& target, bool copyOnWrite = false);
+
 		/** Retrieves the EntityManager */
 		EntityManager& getEntityManager();
 
@@ -46,9 +136,34 @@ namespace Atlas
 		/** Retrieves the GroupManager */
 		GroupManager& getGroupManager();
 
+		/** Retrieves the HierarchyManager */
+		HierarchyManager& getHierarchyManager();
+
+		/** Retrieves the QueryManager */
+		QueryManager& getQueryManager();
+
+		/** Retrieves the FieldManager */
+		FieldManager& getFieldManager();
+
+		/** Retrieves the ObserverManager */
+		ObserverManager& getObserverManager();
+
+		/** Retrieves the ResourceManager */
+		ResourceManager& getResourceManager();
+
+		/** Retrieves the Profiler */
+		Profiler& getProfiler();
+
 	private:
 		EntityManager          mEntityManager;
+		QueryManager           mQueryManager;
 		SystemManager          mSystemManager;
 		GroupManager           mGroupManager;
+		HierarchyManager       mHierarchyManager;
+		FieldManager           mFieldManager;
+		ObserverManager        mObserverManager;
+		ResourceManager        mResourceManager;
+		Profiler               mProfiler;
+		bool                   mDefragmenting;
 	};
 }
\ No newline at end of file
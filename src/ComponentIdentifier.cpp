@@ -2,9 +2,12 @@
 
 namespace Atlas
 {
-	ComponentIdentifier::ComponentIdentifier()
+	ComponentIdentifier::ComponentIdentifier(const char* name)
 		: mID(nextID++)
 		, mBit(nextBit)
+		, mName(name)
+		, mSize(0)
+		, mCopy(nullptr)
 	{
 		nextBit <<= 1;
 	}
@@ -20,6 +23,21 @@ namespace Atlas
 		return mBit;
 	}
 
+	const char* ComponentIdentifier::getName() const
+	{
+		return mName;
+	}
+
+	std::size_t ComponentIdentifier::getSize() const
+	{
+		return mSize.load(std::memory_order_relaxed);
+	}
+
+	ComponentIdentifier::CopyFunction ComponentIdentifier::getCopyFunction() const
+	{
+		return mCopy.load(std::memory_order_relaxed);
+	}
+
 	unsigned int ComponentIdentifier::nextID = 0;
 	std::bitset<BITSIZE> ComponentIdentifier::nextBit(1);
 }
\ No newline at end of file
@@ -1,19 +1,63 @@
 #include "ComponentIdentifierManager.h"
 #include "ComponentIdentifier.h"
 
+namespace
+{
+	/** Created by the first lookup, from any thread */
+	std::once_flag registryFlag;
+	Atlas::TypeRegistry<Atlas::ComponentIdentifier::Ptr>* registry = nullptr;
+}
+
 namespace Atlas
 {
 	ComponentIdentifier& ComponentIdentifierManager::getType(const std::type_index& index)
 	{
 		// If an identifier is not assigned, assign one
-		if (ComponentMap[index] == nullptr)
+		return *getRegistry().findOrAdd(index, [&index](std::size_t)
 		{
-			ComponentIdentifier::Ptr id(new ComponentIdentifier());
-			ComponentMap[index] = std::move(id);
-		}
+			return ComponentIdentifier::Ptr(new ComponentIdentifier(index.name()));
+		});
+	}
+
+	ComponentIdentifier& ComponentIdentifierManager::getType(const std::type_index& index, std::size_t size)
+	{
+		ComponentIdentifier& identifier = getType(index);
+		identifier.mSize.store(size, std::memory_order_relaxed);
+
+		return identifier;
+	}
+
+	ComponentIdentifier& ComponentIdentifierManager::getType(const std::type_index& index, std::size_t size, ComponentIdentifier::CopyFunction copy)
+	{
+		ComponentIdentifier& identifier = getType(index, size);
+		identifier.mCopy.store(copy, std::memory_order_relaxed);
+
+		return identifier;
+	}
 
-		return *ComponentMap[index];
+	std::vector<const ComponentIdentifier*> ComponentIdentifierManager::getAllTypes()
+	{
+		const TypeRegistry<ComponentIdentifier::Ptr>& registry = getRegistry();
+		std::vector<const ComponentIdentifier*> types;
+
+		for (std::size_t i = 0; i < registry.size(); i++)
+			types.push_back(registry.at(i).get());
+
+		return types;
+	}
+
+	void ComponentIdentifierManager::freeze()
+	{
+		getRegistry().freeze();
 	}
 
-	std::unordered_map <std::type_index, ComponentIdentifier::Ptr> ComponentIdentifierManager::ComponentMap;
+	bool ComponentIdentifierManager::isFrozen()
+	{
+		return getRegistry().isFrozen();
+	}
+
+	TypeRegistry<ComponentIdentifier::Ptr>& ComponentIdentifierManager::getRegistry()
+	{
+		return TypeRegistry<ComponentIdentifier::Ptr>::getShared(registryFlag, registry);
+	}
 }
\ No newline at end of file
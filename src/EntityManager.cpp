@@ -1,12 +1,58 @@
 #include "EntityManager.h"
 #include "World.h"
+#include "Query.h"
+#include "SpawnBuffer.h"
+#include "Prefab.h"
 
+#include <algorithm>
 #include <iostream>
 
+// SSE2 is part of every x64 target, and of x86 builds that enable it
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ATLAS_SSE2 1
+#include <emmintrin.h>
+#else
+#define ATLAS_SSE2 0
+#endif
 
 namespace
 {
 	const int POOLSIZE = 100;
+
+	/** Signature bit of active Entities, above every Component bit */
+	const std::uint64_t ALIVE = static_cast<std::uint64_t>(1) << 63;
+	static_assert(Atlas::BITSIZE < 64, "Component bits must fit in a signature word");
+
+	/** Orders the dead Entity pool as a min-heap on Entity::ID */
+	struct HigherID
+	{
+		bool operator()(const Atlas::Entity::Ptr& a, const Atlas::Entity::Ptr& b) const
+		{
+			return a->getID() > b->getID();
+		}
+	};
+
+	/** Copies every Component in a table */
+	std::shared_ptr<std::vector<Atlas::Component::Ptr>> copyTable(const std::vector<Atlas::Component::Ptr>& table)
+	{
+		std::shared_ptr<std::vector<Atlas::Component::Ptr>> copy(new std::vector<Atlas::Component::Ptr>(table.size()));
+		Atlas::ComponentIdentifier::CopyFunction copyComponent = nullptr;
+
+		for (std::size_t id = 0; id < table.size(); id++)
+		{
+			if (table[id] == nullptr)
+				continue;
+
+			// every Component in a table has the same type
+			if (copyComponent == nullptr)
+				copyComponent = Atlas::ComponentIdentifierManager::getType(typeid(*table[id])).getCopyFunction();
+
+			assert(copyComponent != nullptr && "Component type can not be copied");
+			(*copy)[id].reset(copyComponent(*table[id]));
+		}
+
+		return copy;
+	}
 }
 
 namespace Atlas
@@ -15,15 +61,33 @@ namespace Atlas
 		: mWorld(world)
 		, mActiveEntityCount(0)
 		, mNextAvaibleID(0)
+		, mReservedCount(0)
 		, mActiveEntities(POOLSIZE)
 		, mDeadEntities()
 		, mComponentsByType(BITSIZE)
+		, mSignatures(POOLSIZE, 0)
 		, mEntityComponents()
 	{
+		for (auto& table : mComponentsByType)
+			table = std::make_shared<ComponentTable>();
 	}
 
 	void EntityManager::update()
 	{
+		HierarchyManager& hierarchy = mWorld.getHierarchyManager();
+
+		// children are destroyed with their parents, starting from the highest destroyed
+		// ancestor so every subtree is only walked once
+		for (auto& entity : mActiveEntities)
+		{
+			if (entity && !entity->isActive() && hierarchy.hasChildren(*entity))
+			{
+				const Entity::ID parent = hierarchy.getParent(*entity);
+				if (parent == Relationship::NONE || mActiveEntities[parent]->isActive())
+					hierarchy.destroyDescendants(*entity);
+			}
+		}
+
 		// remove inactive entities
 		for (auto& entity : mActiveEntities)
 			if (entity && !entity->isActive())
@@ -32,15 +96,17 @@ namespace Atlas
 
 	Entity& EntityManager::createEntity()
 	{
+		ATLAS_PROFILE(mWorld.getProfiler(), Profiler::CREATE_ENTITY, Profiler::NO_TYPE);
+
 		std::unique_ptr<Entity> e;
 
 		// If a dead entity is pooled, set it to active and it will be the created entity
 		if (!mDeadEntities.empty())
 		{
-			e = std::move(mDeadEntities.top());
-			mDeadEntities.pop();
+			e = takeLowestDeadEntity();
 		}
-		// if not, allocate a new entity, move it into our vector and increament ID
+		// if not, allocate a new entity, move it into our vector and increament ID,
+		// atomically as SpawnBuffers may be reserving IDs at the same time
 		else
 		{
 			e.reset(new Entity(mWorld, mNextAvaibleID++));
@@ -52,12 +118,13 @@ namespace Atlas
 		Entity::ID id = e->getID();
 
 		// make sure the id fits the container
-		if (mActiveEntities.capacity() <= id)
+		if (mActiveEntities.size() <= id)
 		{
 			mActiveEntities.resize(id * 2 + 1);
 		}
 
 		mActiveEntities[id] = std::move(e);
+		updateSignature(*mActiveEntities[id]);
 
 		return *mActiveEntities[id];
 
@@ -67,23 +134,162 @@ namespace Atlas
 	{
 		// Only remove inactive entities
 		assert(!entity.isActive());
+		ATLAS_PROFILE(mWorld.getProfiler(), Profiler::REAP_ENTITY, Profiler::NO_TYPE);
 
 		const auto& id = entity.getID();
 
 		mWorld.getGroupManager().removeFromAllGroups(entity);
+		mWorld.getHierarchyManager().removeEntity(entity);
 
 		// Deactivate entity and reset properties
 		removeAllComponentsFor(entity);
 		mActiveEntities[id]->reset();
+		mSignatures[id] = 0;
 
 		// Move entity to dead entity pool and set active element to null
-		mDeadEntities.push(std::move(mActiveEntities[id]));
+		mDeadEntities.push_back(std::move(mActiveEntities[id]));
+		std::push_heap(mDeadEntities.begin(), mDeadEntities.end(), HigherID());
 
 		mActiveEntities[id] = nullptr;
 
 		mActiveEntityCount--;
 	}
 
+	std::vector<Entity::ID> EntityManager::instantiate(const Prefab& prefab, std::size_t count)
+	{
+		std::vector<Entity::ID> ids;
+		ids.reserve(count);
+
+		Entity::ID highest = 0;
+		for (std::size_t i = 0; i < count; i++)
+		{
+			Entity& entity = createEntity();
+			entity.addComponentBit(prefab.mComponentBits);
+			updateSignature(entity);
+
+			ids.push_back(entity.getID());
+			highest = std::max(highest, entity.getID());
+		}
+
+		if (count == 0)
+			return ids;
+
+		ObserverManager& oManager = mWorld.getObserverManager();
+
+		// each table is looked up and sized once, then filled with copies of the prototype
+		for (const auto& prototype : prefab.mPrototypes)
+		{
+			ATLAS_PROFILE_BATCH(mWorld.getProfiler(), Profiler::ADD_COMPONENT, prototype.identifier->getID(), count);
+
+			const ComponentIdentifier::CopyFunction copyComponent = prototype.identifier->getCopyFunction();
+			auto& typeComponents = getTable(prototype.identifier->getID());
+
+			if (typeComponents.size() <= highest)
+				typeComponents.resize(highest * 2 + 1);
+
+			for (const auto& id : ids)
+				typeComponents[id].reset(copyComponent(*prototype.component));
+
+			for (const auto& id : ids)
+				oManager.constructed(prototype.identifier->getID(), id, typeComponents[id].get());
+		}
+
+		mWorld.getFieldManager().addRow(highest);
+		mWorld.getQueryManager().addEntities(prefab.mComponentBits, ids);
+
+		return ids;
+	}
+
+	void EntityManager::commit(SpawnBuffer& buffer)
+	{
+		assert(&buffer.mEntityManager == this);
+
+		// blocks are reserved in any order across buffers, so the container is sized for the block end
+		if (buffer.mBlockEnd > 0 && mActiveEntities.size() < buffer.mBlockEnd)
+			mActiveEntities.resize(buffer.mBlockEnd * 2 + 1);
+
+		{
+			ATLAS_PROFILE_BATCH(mWorld.getProfiler(), Profiler::CREATE_ENTITY, Profiler::NO_TYPE, buffer.mEntities.size());
+
+			for (const auto& id : buffer.mEntities)
+			{
+				assert(mActiveEntities[id] == nullptr);
+				mActiveEntities[id].reset(new Entity(mWorld, id));
+				mActiveEntities[id]->setActive(true);
+				mActiveEntityCount++;
+			}
+		}
+
+		// the unused rest of the block is pooled, so every id below the next new id is active or dead
+		for (Entity::ID id = buffer.mNextID; id < buffer.mBlockEnd; id++)
+		{
+			mDeadEntities.push_back(Entity::Ptr(new Entity(mWorld, id)));
+			std::push_heap(mDeadEntities.begin(), mDeadEntities.end(), HigherID());
+		}
+
+		std::vector<Entity::ID> changed(buffer.mEntities);
+		FieldManager& fManager = mWorld.getFieldManager();
+		ObserverManager& oManager = mWorld.getObserverManager();
+
+		// each shard is merged into its table with a single lookup and resize
+		for (auto& shard : buffer.mShards)
+		{
+			if (shard.owners.empty())
+				continue;
+
+			const ComponentIdentifier& identifier = *shard.identifier;
+			ATLAS_PROFILE_BATCH(mWorld.getProfiler(), Profiler::ADD_COMPONENT, identifier.getID(), shard.owners.size());
+
+			auto& typeComponents = getTable(identifier.getID());
+
+			const Entity::ID highest = *std::max_element(shard.owners.begin(), shard.owners.end());
+			if (typeComponents.size() <= highest)
+				typeComponents.resize(highest * 2 + 1);
+
+			for (std::size_t i = 0; i < shard.owners.size(); i++)
+			{
+				const Entity::ID id = shard.owners[i];
+
+				// a Component of a type the Entity owns replaces it, as with addComponent()
+				if (typeComponents[id] != nullptr)
+				{
+					oManager.destroyed(identifier.getID(), id, typeComponents[id]);
+					fManager.clearRow(identifier.getID(), id);
+				}
+				else
+				{
+					getEntity(id).addComponentBit(identifier.getBit());
+				}
+
+				typeComponents[id] = std::move(shard.components[i]);
+				fManager.addRow(id);
+				oManager.constructed(identifier.getID(), id, typeComponents[id].get());
+			}
+
+			changed.insert(changed.end(), shard.owners.begin(), shard.owners.end());
+			shard.owners.clear();
+			shard.components.clear();
+		}
+
+		// one interest check per Entity instead of one per Component
+		std::sort(changed.begin(), changed.end());
+		changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+		SystemManager& sManager = mWorld.getSystemManager();
+		for (const auto& id : changed)
+		{
+			Entity& entity = getEntity(id);
+			updateSignature(entity);
+			sManager.checkInterest(entity);
+		}
+
+		mReservedCount.fetch_sub(buffer.mReserved, std::memory_order_relaxed);
+		buffer.mReserved = 0;
+		buffer.mNextID = 0;
+		buffer.mBlockEnd = 0;
+		buffer.mEntities.clear();
+	}
+
 	Entity& EntityManager::getEntity(const Entity::ID& id) const
 	{
 		assert(id < mActiveEntities.size());
@@ -94,11 +300,12 @@ namespace Atlas
 	{
 		const ComponentIdentifier& identifier = ComponentIdentifierManager::getType(typeid(*component));
 		const Entity::ID& eID = entity.getID();
+		ATLAS_PROFILE(mWorld.getProfiler(), Profiler::ADD_COMPONENT, identifier.getID());
 
-		auto& typeComponents = mComponentsByType[identifier.getID()];
+		auto& typeComponents = getTable(identifier.getID());
 
 		// make sure the id fits the container
-		if (typeComponents.capacity() <= eID)
+		if (typeComponents.size() <= eID)
 		{
 			typeComponents.resize(eID * 2 + 1);
 		}
@@ -111,6 +318,9 @@ namespace Atlas
 
 		entity.addComponentBit(identifier.getBit());
 		typeComponents[eID] = std::move(component);
+		mWorld.getFieldManager().addRow(eID);
+		mWorld.getObserverManager().constructed(identifier.getID(), eID, typeComponents[eID].get());
+		updateSignature(entity);
 
 		// Check all systems for interest in new component
 		mWorld.getSystemManager().checkInterest(entity);
@@ -118,14 +328,21 @@ namespace Atlas
 
 	void EntityManager::removeComponent(Entity& entity, const ComponentIdentifier& id)
 	{
+		ATLAS_PROFILE(mWorld.getProfiler(), Profiler::REMOVE_COMPONENT, id.getID());
+
+		auto& typeComponents = getTable(id.getID());
+
 		// Check if specific component vector not out of range
-		assert(mComponentsByType[id.getID()].capacity() > entity.getID());
+		assert(typeComponents.size() > entity.getID());
 
 		// Check if entity has component first
-		assert(mComponentsByType[id.getID()][entity.getID()] != nullptr);
+		assert(typeComponents[entity.getID()] != nullptr);
 
 		entity.removeComponentBit(id.getBit());
-		mComponentsByType[id.getID()][entity.getID()] = nullptr;
+		mWorld.getObserverManager().destroyed(id.getID(), entity.getID(), typeComponents[entity.getID()]);
+		typeComponents[entity.getID()] = nullptr;
+		mWorld.getFieldManager().clearRow(id.getID(), entity.getID());
+		updateSignature(entity);
 
 		// Check all systems to see if still interested in entity
 		mWorld.getSystemManager().checkInterest(entity);
@@ -140,7 +357,7 @@ namespace Atlas
 		for (int i = 0; i < entityBits.size(); i++)
 		{
 			if (entityBits[i])
-				mEntityComponents.push_back(mComponentsByType[i][entity.getID()].get());
+				mEntityComponents.push_back(readTable(i)[entity.getID()].get());
 		}
 
 		return mEntityComponents;
@@ -153,20 +370,436 @@ namespace Atlas
 		for (int i = 0; i < mComponentsByType.size(); i++)
 		{
 			// check if vector is out of range and if there is a component for the entity present
-			if (mComponentsByType[i].size() > id && mComponentsByType[i][id] != nullptr)
+			if (readTable(i).size() > id && readTable(i)[id] != nullptr)
 			{
+				auto& typeComponents = getTable(i);
+
 				// get ComponentIdentifier for this component
-				const auto& type = ComponentIdentifierManager::getType(typeid(*mComponentsByType[i][id]));
+				const auto& type = ComponentIdentifierManager::getType(typeid(*typeComponents[id]));
 
 				entity.removeComponentBit(type.getBit());
-				mComponentsByType[i][id] = nullptr;
+				mWorld.getObserverManager().destroyed(i, id, typeComponents[id]);
+				typeComponents[id] = nullptr;
+				mWorld.getFieldManager().clearRow(i, id);
 			}
 		}
 
+		updateSignature(entity);
+
 		// Check all systems to remove entity from them
 		mWorld.getSystemManager().checkInterest(entity);
 	}
 
+	void EntityManager::clear()
+	{
+		for (auto& entity : mActiveEntities)
+		{
+			if (entity != nullptr)
+			{
+				entity->setActive(false);
+				removeEntity(*entity);
+			}
+		}
+
+		releaseDeadEntitiesFrom(0);
+	}
+
+	void EntityManager::reportMemory(MemoryReport& report) const
+	{
+		// Entity table, dead Entity pool and the temp Component container
+		report.entities.live += mActiveEntityCount * (sizeof(Entity::Ptr) + sizeof(Entity));
+		report.entities.reserved += mActiveEntities.capacity() * sizeof(Entity::Ptr)
+			+ (mActiveEntityCount + mDeadEntities.size()) * sizeof(Entity)
+			+ mDeadEntities.size() * sizeof(Entity::Ptr)
+			+ mEntityComponents.capacity() * sizeof(Component*)
+			+ mSignatures.capacity() * sizeof(std::uint64_t);
+
+		for (const auto* type : ComponentIdentifierManager::getAllTypes())
+		{
+			const auto& typeComponents = readTable(type->getID());
+
+			MemoryReport::ComponentUsage usage;
+			usage.name = type->getName();
+			usage.id = type->getID();
+			usage.count = 0;
+
+			for (const auto& component : typeComponents)
+				if (component != nullptr)
+					usage.count++;
+
+			usage.usage.live = usage.count * (sizeof(Component::Ptr) + type->getSize());
+			usage.usage.reserved = typeComponents.capacity() * sizeof(Component::Ptr) + usage.count * type->getSize();
+
+			report.components.push_back(usage);
+		}
+	}
+
+	void EntityManager::shrinkToFit()
+	{
+		// reserved ids may lie above the highest active id
+		if (mReservedCount.load(std::memory_order_relaxed) != 0)
+			return;
+
+		// find the highest active id, everything above it can be released
+		std::size_t size = mActiveEntities.size();
+		while (size > 0 && mActiveEntities[size - 1] == nullptr)
+			size--;
+
+		mActiveEntities.resize(size);
+		mActiveEntities.shrink_to_fit();
+		mSignatures.resize(size);
+		mSignatures.shrink_to_fit();
+
+		// destroy dead entities that are above the active range so their ids are reissued
+		releaseDeadEntitiesFrom(size);
+		mDeadEntities.shrink_to_fit();
+
+		// trim each component table to its last component, tables shared with a clone are left alone
+		for (auto& table : mComponentsByType)
+		{
+			if (table.use_count() > 1)
+				continue;
+
+			auto& typeComponents = *table;
+
+			std::size_t typeSize = std::min(typeComponents.size(), size);
+			while (typeSize > 0 && typeComponents[typeSize - 1] == nullptr)
+				typeSize--;
+
+			typeComponents.resize(typeSize);
+			typeComponents.shrink_to_fit();
+		}
+
+		mEntityComponents.shrink_to_fit();
+
+		// fields are trimmed to the same active range, Entities above it own no Components
+		mWorld.getFieldManager().shrinkToFit(size);
+	}
+
+	std::vector<Entity::Relocation> EntityManager::defragment(unsigned int maxMoves)
+	{
+		std::vector<Entity::Relocation> relocations;
+
+		std::size_t top = mActiveEntities.size();
+
+		while (relocations.size() < maxMoves && !mDeadEntities.empty())
+		{
+			// find the highest active entity
+			while (top > 0 && mActiveEntities[top - 1] == nullptr)
+				top--;
+
+			const Entity::ID from = top - 1;
+			const Entity::ID to = mDeadEntities.front()->getID();
+
+			// nothing left above the lowest free id
+			if (top == 0 || to >= from)
+				break;
+
+			// the lowest free id is taken by the active entity, the id it
+			// vacates is above the new top and is released below
+			takeLowestDeadEntity();
+
+			mActiveEntities[from]->setID(to);
+			mActiveEntities[to] = std::move(mActiveEntities[from]);
+			mSignatures[to] = mSignatures[from];
+			mSignatures[from] = 0;
+
+			for (unsigned int type = 0; type < mComponentsByType.size(); type++)
+			{
+				if (readTable(type).size() > from && readTable(type)[from] != nullptr)
+				{
+					auto& typeComponents = getTable(type);
+					typeComponents[to] = std::move(typeComponents[from]);
+				}
+			}
+
+			relocations.push_back(Entity::Relocation(from, to));
+			top = from;
+		}
+
+		while (top > 0 && mActiveEntities[top - 1] == nullptr)
+			top--;
+
+		// ids above the highest active entity are released
+		releaseDeadEntitiesFrom(top);
+
+		if (!relocations.empty())
+		{
+			mWorld.getQueryManager().remapEntities(relocations);
+			mWorld.getGroupManager().remapEntities(relocations);
+			mWorld.getHierarchyManager().remapEntities(relocations);
+			mWorld.getFieldManager().remapEntities(relocations);
+			mWorld.getObserverManager().remapEntities(relocations);
+		}
+
+		return relocations;
+	}
+
+	void EntityManager::cloneTo(EntityManager& target, bool copyOnWrite) const
+	{
+		assert(&target != this);
+		assert(mReservedCount == 0 && "Commit every SpawnBuffer first");
+
+		mWorld.getGroupManager().cloneTo(target.mWorld.getGroupManager());
+		mWorld.getHierarchyManager().cloneTo(target.mWorld.getHierarchyManager());
+		mWorld.getFieldManager().cloneTo(target.mWorld.getFieldManager());
+
+		// the Components of the target are replaced without being added or removed
+		target.mWorld.getObserverManager().clear();
+
+		// the Entity objects of the target are reused, so cloning every frame does not allocate
+		std::vector<Entity::Ptr> spare = std::move(target.mDeadEntities);
+		for (auto& entity : target.mActiveEntities)
+			if (entity != nullptr)
+				spare.push_back(std::move(entity));
+
+		auto copyEntity = [&target, &spare](const Entity& entity)
+		{
+			Entity::Ptr copy;
+			if (spare.empty())
+			{
+				copy.reset(new Entity(target.mWorld, entity.mID));
+			}
+			else
+			{
+				copy = std::move(spare.back());
+				spare.pop_back();
+				copy->reset();
+				copy->mID = entity.mID;
+			}
+
+			copy->mIsActive = entity.mIsActive;
+			return copy;
+		};
+
+		// Entities
+		target.mActiveEntities.clear();
+		target.mActiveEntities.resize(mActiveEntities.size());
+
+		for (const auto& entity : mActiveEntities)
+		{
+			if (entity == nullptr)
+				continue;
+
+			Entity::Ptr copy = copyEntity(*entity);
+			copy->mComponentBits = entity->mComponentBits;
+
+			target.mActiveEntities[entity->mID] = std::move(copy);
+		}
+
+		// the pool is copied in heap order
+		target.mDeadEntities.clear();
+		target.mDeadEntities.reserve(mDeadEntities.size());
+
+		for (const auto& entity : mDeadEntities)
+			target.mDeadEntities.push_back(copyEntity(*entity));
+
+		target.mActiveEntityCount = mActiveEntityCount;
+		target.mNextAvaibleID = mNextAvaibleID.load();
+		target.mSignatures = mSignatures;
+
+		// Components, the old tables of the target are released without being copied
+		for (std::size_t type = 0; type < mComponentsByType.size(); type++)
+		{
+			if (copyOnWrite)
+				target.mComponentsByType[type] = mComponentsByType[type];
+			else
+				target.mComponentsByType[type] = copyTable(*mComponentsByType[type]);
+		}
+
+		// System bits are set again from the Queries of the target
+		mWorld.getQueryManager().cloneTo(target.mWorld.getQueryManager());
+	}
+
+	EntityManager::ComponentTable& EntityManager::getTable(unsigned int type) const
+	{
+		auto& table = mComponentsByType[type];
+
+		// copy on write, the table is shared with a clone
+		if (table.use_count() > 1)
+		{
+			std::shared_ptr<ComponentTable> copy = copyTable(*table);
+			mWorld.getObserverManager().remapComponents(type, *table, *copy);
+			table = copy;
+		}
+
+		return *table;
+	}
+
+	const EntityManager::ComponentTable& EntityManager::readTable(unsigned int type) const
+	{
+		return *mComponentsByType[type];
+	}
+
+	Entity::Ptr EntityManager::takeLowestDeadEntity()
+	{
+		std::pop_heap(mDeadEntities.begin(), mDeadEntities.end(), HigherID());
+
+		Entity::Ptr entity = std::move(mDeadEntities.back());
+		mDeadEntities.pop_back();
+
+		return entity;
+	}
+
+	void EntityManager::releaseDeadEntitiesFrom(Entity::ID id)
+	{
+		// reserved ids above the limit would be handed out twice, so nothing is
+		// released until every SpawnBuffer is committed
+		if (mReservedCount.load(std::memory_order_relaxed) != 0)
+			return;
+
+		auto released = std::remove_if(mDeadEntities.begin(), mDeadEntities.end(),
+			[id](const Entity::Ptr& entity) { return entity->getID() >= id; });
+
+		if (released != mDeadEntities.end())
+		{
+			mDeadEntities.erase(released, mDeadEntities.end());
+			std::make_heap(mDeadEntities.begin(), mDeadEntities.end(), HigherID());
+		}
+
+		mNextAvaibleID = id;
+	}
+
+	void EntityManager::restoreEntities(const Entity::ID* ids, std::size_t count, Entity::ID nextID)
+	{
+		// pool the new ids so every id below nextID is active or dead
+		if (mNextAvaibleID < nextID)
+		{
+			if (mActiveEntities.size() < nextID)
+				mActiveEntities.resize(nextID);
+
+			for (Entity::ID id = mNextAvaibleID; id < nextID; id++)
+				mDeadEntities.push_back(Entity::Ptr(new Entity(mWorld, id)));
+
+			mNextAvaibleID = nextID;
+		}
+
+		ATLAS_PROFILE_BATCH(mWorld.getProfiler(), Profiler::CREATE_ENTITY, Profiler::NO_TYPE, count);
+
+		// take the restored ids out of the pool in a single pass
+		std::vector<bool> isRestored(mNextAvaibleID, false);
+		for (std::size_t i = 0; i < count; i++)
+		{
+			assert(ids[i] < mNextAvaibleID && mActiveEntities[ids[i]] == nullptr);
+			isRestored[ids[i]] = true;
+		}
+
+		auto restored = std::partition(mDeadEntities.begin(), mDeadEntities.end(),
+			[&isRestored](const Entity::Ptr& entity) { return !isRestored[entity->getID()]; });
+
+		for (auto itr = restored; itr != mDeadEntities.end(); itr++)
+		{
+			const Entity::ID id = (*itr)->getID();
+			(*itr)->setActive(true);
+			mActiveEntities[id] = std::move(*itr);
+			mActiveEntityCount++;
+			updateSignature(*mActiveEntities[id]);
+		}
+
+		mDeadEntities.erase(restored, mDeadEntities.end());
+		std::make_heap(mDeadEntities.begin(), mDeadEntities.end(), HigherID());
+	}
+
+	void EntityManager::reserveComponents(const ComponentIdentifier& identifier, std::size_t size)
+	{
+		if (readTable(identifier.getID()).size() < size)
+			getTable(identifier.getID()).resize(size);
+	}
+
+	void EntityManager::attachComponent(Entity& entity, const ComponentIdentifier& identifier, Component::Ptr component)
+	{
+		const Entity::ID& eID = entity.getID();
+		ATLAS_PROFILE(mWorld.getProfiler(), Profiler::ADD_COMPONENT, identifier.getID());
+
+		auto& typeComponents = getTable(identifier.getID());
+
+		if (typeComponents.size() <= eID)
+			typeComponents.resize(eID * 2 + 1);
+
+		if (typeComponents[eID] != nullptr)
+			mWorld.getObserverManager().destroyed(identifier.getID(), eID, typeComponents[eID]);
+
+		entity.addComponentBit(identifier.getBit());
+		typeComponents[eID] = std::move(component);
+		mWorld.getFieldManager().addRow(eID);
+		mWorld.getObserverManager().constructed(identifier.getID(), eID, typeComponents[eID].get());
+		updateSignature(entity);
+	}
+
+	void EntityManager::detachComponent(Entity& entity, const ComponentIdentifier& identifier)
+	{
+		auto& typeComponents = getTable(identifier.getID());
+		assert(typeComponents.size() > entity.getID());
+
+		entity.removeComponentBit(identifier.getBit());
+		mWorld.getObserverManager().destroyed(identifier.getID(), entity.getID(), typeComponents[entity.getID()]);
+		typeComponents[entity.getID()] = nullptr;
+		mWorld.getFieldManager().clearRow(identifier.getID(), entity.getID());
+		updateSignature(entity);
+	}
+
+	Entity::ID EntityManager::reserveIDs(unsigned int count)
+	{
+		mReservedCount.fetch_add(count, std::memory_order_relaxed);
+		return mNextAvaibleID.fetch_add(count, std::memory_order_relaxed);
+	}
+
+	void EntityManager::updateSignature(const Entity& entity)
+	{
+		const Entity::ID id = entity.getID();
+
+		// make sure the id fits the container
+		if (mSignatures.size() <= id)
+			mSignatures.resize(mActiveEntities.size(), 0);
+
+		mSignatures[id] = entity.getComponentBits().to_ullong() | ALIVE;
+	}
+
+	void EntityManager::findMatching(const Signature& signature, std::vector<Entity::ID>& matches) const
+	{
+		// the alive bit is tested with the required and excluded bits, so dead ids never match
+		const std::uint64_t mask = (signature.required | signature.excluded).to_ullong() | ALIVE;
+		const std::uint64_t expected = signature.required.to_ullong() | ALIVE;
+
+		const std::size_t count = mSignatures.size();
+		const std::uint64_t* signatures = mSignatures.data();
+
+		// every id is written and the end only advances on a match, so the compaction has no branch
+		matches.resize(count);
+		Entity::ID* output = matches.data();
+		std::size_t found = 0;
+		std::size_t id = 0;
+
+#if ATLAS_SSE2
+		// two signatures per register. SSE2 has no 64 bit compare, so the halves are compared
+		// and a signature matches when both of its halves do
+		const int maskLow = static_cast<int>(mask & 0xFFFFFFFF), maskHigh = static_cast<int>(mask >> 32);
+		const int expectedLow = static_cast<int>(expected & 0xFFFFFFFF), expectedHigh = static_cast<int>(expected >> 32);
+		const __m128i maskVector = _mm_set_epi32(maskHigh, maskLow, maskHigh, maskLow);
+		const __m128i expectedVector = _mm_set_epi32(expectedHigh, expectedLow, expectedHigh, expectedLow);
+
+		for (; id + 2 <= count; id += 2)
+		{
+			const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(signatures + id));
+			const __m128i equal = _mm_cmpeq_epi32(_mm_and_si128(words, maskVector), expectedVector);
+			const int halves = _mm_movemask_ps(_mm_castsi128_ps(equal));
+
+			output[found] = static_cast<Entity::ID>(id);
+			found += (halves & 0x3) == 0x3;
+			output[found] = static_cast<Entity::ID>(id + 1);
+			found += (halves & 0xC) == 0xC;
+		}
+#endif
+
+		for (; id < count; id++)
+		{
+			output[found] = static_cast<Entity::ID>(id);
+			found += (signatures[id] & mask) == expected;
+		}
+
+		matches.resize(found);
+	}
+
 	void EntityManager::toString()
 	{
 		using namespace std;
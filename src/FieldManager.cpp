@@ -0,0 +1,69 @@
+#include "FieldManager.h"
+
+#include <algorithm>
+
+namespace Atlas
+{
+	FieldManager::FieldManager()
+		: mTables(BITSIZE)
+		, mRows(0)
+	{
+	}
+
+	void FieldManager::addRow(Entity::ID id)
+	{
+		mRows = std::max(mRows, static_cast<std::size_t>(id) + 1);
+	}
+
+	void FieldManager::clearRow(unsigned int type, Entity::ID id)
+	{
+		if (mTables[type] != nullptr)
+			mTables[type]->clearRow(id);
+	}
+
+	void FieldManager::remapEntities(const std::vector<Entity::Relocation>& relocations)
+	{
+		for (auto& table : mTables)
+		{
+			if (table == nullptr)
+				continue;
+
+			for (const auto& relocation : relocations)
+				table->moveRow(relocation.first, relocation.second);
+		}
+	}
+
+	void FieldManager::cloneTo(FieldManager& target) const
+	{
+		for (std::size_t type = 0; type < mTables.size(); type++)
+		{
+			if (mTables[type] != nullptr)
+				target.mTables[type] = mTables[type]->clone();
+			else
+				target.mTables[type].reset();
+		}
+
+		target.mRows = mRows;
+	}
+
+	void FieldManager::reportMemory(MemoryReport& report) const
+	{
+		report.fields.reserved += mTables.capacity() * sizeof(std::unique_ptr<FieldTableBase>);
+
+		for (const auto& table : mTables)
+			if (table != nullptr)
+				report.fields += table->getUsage();
+	}
+
+	void FieldManager::shrinkToFit(std::size_t rows)
+	{
+		// rows of active Entities are kept even if every field is zero, as the Entity may own the Component
+		rows = std::min(mRows, rows);
+
+		for (auto& table : mTables)
+			if (table != nullptr)
+				table->shrink(rows);
+
+		mRows = rows;
+	}
+}
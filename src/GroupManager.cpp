@@ -1,5 +1,6 @@
 #include "GroupManager.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
@@ -59,6 +60,10 @@ namespace Atlas
 	{
 		const auto& ID = entity.getID();
 
+		// the Entity was never added to a group
+		if (mEntityGroups.size() <= ID)
+			return;
+
 		for (const auto& name : mEntityGroups[ID])
 		{
 			removeFromGroup(name, entity, true);
@@ -67,6 +72,80 @@ namespace Atlas
 		mEntityGroups[ID].clear();
 	}
 
+	void GroupManager::remapEntities(const std::vector<Entity::Relocation>& relocations)
+	{
+		for (const auto& relocation : relocations)
+		{
+			const auto& from = relocation.first;
+			const auto& to = relocation.second;
+
+			// the Entity is not in any group
+			if (mEntityGroups.size() <= from || mEntityGroups[from].empty())
+				continue;
+
+			for (const auto& name : mEntityGroups[from])
+			{
+				auto& group = mGroupsByName[name];
+				std::replace(group.begin(), group.end(), from, to);
+			}
+
+			// relocations always move down, so the new id fits the table
+			mEntityGroups[to] = std::move(mEntityGroups[from]);
+			mEntityGroups[from].clear();
+		}
+	}
+
+	void GroupManager::cloneTo(GroupManager& target) const
+	{
+		target.mGroupsByName = mGroupsByName;
+		target.mEntityGroups = mEntityGroups;
+	}
+
+	void GroupManager::reportMemory(MemoryReport& report) const
+	{
+		// Group - Entities table
+		for (const auto& group : mGroupsByName)
+		{
+			report.groups.live += sizeof(group) + group.second.size() * sizeof(Entity::ID);
+			report.groups.reserved += sizeof(group) + group.second.capacity() * sizeof(Entity::ID);
+		}
+
+		// ID - Groups table
+		report.groups.reserved += mEntityGroups.capacity() * sizeof(std::vector<std::string>);
+		for (const auto& names : mEntityGroups)
+		{
+			report.groups.live += names.size() * sizeof(std::string);
+			report.groups.reserved += names.capacity() * sizeof(std::string);
+		}
+	}
+
+	void GroupManager::shrinkToFit()
+	{
+		for (auto itr = mGroupsByName.begin(); itr != mGroupsByName.end();)
+		{
+			if (itr->second.empty())
+			{
+				itr = mGroupsByName.erase(itr);
+			}
+			else
+			{
+				itr->second.shrink_to_fit();
+				itr++;
+			}
+		}
+
+		// trim the table to the last Entity that is in a group
+		std::size_t size = mEntityGroups.size();
+		while (size > 0 && mEntityGroups[size - 1].empty())
+			size--;
+
+		mEntityGroups.resize(size);
+		mEntityGroups.shrink_to_fit();
+
+		for (auto& names : mEntityGroups)
+			names.shrink_to_fit();
+	}
+
 	void GroupManager::toString()
 	{
 		using namespace std;
@@ -0,0 +1,329 @@
+#include "HierarchyManager.h"
+#include "World.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+namespace Atlas
+{
+	const Entity::ID Relationship::NONE;
+
+	Relationship::Relationship()
+		: parent(NONE)
+		, firstChild(NONE)
+		, nextSibling(NONE)
+		, prevSibling(NONE)
+	{
+	}
+
+	HierarchyManager::HierarchyManager(World& world)
+		: mWorld(world)
+		, mRelationships()
+		, mDepthFirst()
+		, mRanks()
+		, mVersion(0)
+		, mIsSorted(true)
+	{
+	}
+
+	void HierarchyManager::setParent(const Entity& child, const Entity& parent)
+	{
+		const Entity::ID childID = child.getID();
+		const Entity::ID parentID = parent.getID();
+
+		grow(std::max(childID, parentID));
+
+		// a child can not be its own ancestor
+		assert(!isAncestor(childID, parentID));
+
+		detach(childID);
+
+		// children are added to the front of the sibling list
+		Relationship& relationship = mRelationships[childID];
+		Relationship& parentRelationship = mRelationships[parentID];
+
+		relationship.parent = parentID;
+		relationship.prevSibling = Relationship::NONE;
+		relationship.nextSibling = parentRelationship.firstChild;
+
+		if (parentRelationship.firstChild != Relationship::NONE)
+			mRelationships[parentRelationship.firstChild].prevSibling = childID;
+
+		parentRelationship.firstChild = childID;
+
+		markChanged();
+	}
+
+	void HierarchyManager::removeParent(const Entity& child)
+	{
+		if (getParent(child) == Relationship::NONE)
+			return;
+
+		detach(child.getID());
+		markChanged();
+	}
+
+	Entity::ID HierarchyManager::getParent(const Entity& entity) const
+	{
+		return getRelationship(entity.getID()).parent;
+	}
+
+	std::vector<Entity::ID> HierarchyManager::getChildren(const Entity& entity) const
+	{
+		std::vector<Entity::ID> children;
+
+		for (Entity::ID id = getRelationship(entity.getID()).firstChild; id != Relationship::NONE; id = mRelationships[id].nextSibling)
+			children.push_back(id);
+
+		return children;
+	}
+
+	bool HierarchyManager::hasChildren(const Entity& entity) const
+	{
+		return getRelationship(entity.getID()).firstChild != Relationship::NONE;
+	}
+
+	const Relationship& HierarchyManager::getRelationship(Entity::ID id) const
+	{
+		static const Relationship none;
+
+		if (id >= mRelationships.size())
+			return none;
+
+		return mRelationships[id];
+	}
+
+	void HierarchyManager::destroyDescendants(const Entity& entity)
+	{
+		std::vector<Entity::ID> pending(1, entity.getID());
+
+		while (!pending.empty())
+		{
+			const Entity::ID id = pending.back();
+			pending.pop_back();
+
+			for (Entity::ID child = getRelationship(id).firstChild; child != Relationship::NONE; child = mRelationships[child].nextSibling)
+			{
+				mWorld.getEntity(child).setActive(false);
+				pending.push_back(child);
+			}
+		}
+	}
+
+	const std::vector<Entity::ID>& HierarchyManager::getDepthFirstOrder()
+	{
+		sort();
+		return mDepthFirst;
+	}
+
+	void HierarchyManager::sortDepthFirst(std::vector<Entity::ID>& ids)
+	{
+		sort();
+
+		const std::vector<Entity::ID>& ranks = mRanks;
+		std::sort(ids.begin(), ids.end(), [&ranks](Entity::ID a, Entity::ID b)
+		{
+			const Entity::ID rankA = a < ranks.size() ? ranks[a] : Relationship::NONE;
+			const Entity::ID rankB = b < ranks.size() ? ranks[b] : Relationship::NONE;
+
+			return rankA != rankB ? rankA < rankB : a < b;
+		});
+	}
+
+	unsigned int HierarchyManager::getVersion() const
+	{
+		return mVersion;
+	}
+
+	void HierarchyManager::removeEntity(const Entity& entity)
+	{
+		const Entity::ID id = entity.getID();
+		const Relationship& relationship = getRelationship(id);
+
+		// the Entity is not in a hierarchy
+		if (relationship.parent == Relationship::NONE && relationship.firstChild == Relationship::NONE)
+			return;
+
+		detach(id);
+
+		// children become roots
+		Entity::ID child = mRelationships[id].firstChild;
+		while (child != Relationship::NONE)
+		{
+			const Entity::ID next = mRelationships[child].nextSibling;
+			mRelationships[child] = Relationship();
+			child = next;
+		}
+
+		mRelationships[id].firstChild = Relationship::NONE;
+		markChanged();
+	}
+
+	void HierarchyManager::remapEntities(const std::vector<Entity::Relocation>& relocations)
+	{
+		bool isChanged = false;
+
+		for (const auto& relocation : relocations)
+		{
+			const auto& from = relocation.first;
+			const auto& to = relocation.second;
+
+			// the Entity is not in a hierarchy
+			const Relationship relationship = getRelationship(from);
+			if (relationship.parent == Relationship::NONE && relationship.firstChild == Relationship::NONE)
+				continue;
+
+			// point every link to the Entity at its new id
+			if (relationship.prevSibling != Relationship::NONE)
+				mRelationships[relationship.prevSibling].nextSibling = to;
+			else if (relationship.parent != Relationship::NONE)
+				mRelationships[relationship.parent].firstChild = to;
+
+			if (relationship.nextSibling != Relationship::NONE)
+				mRelationships[relationship.nextSibling].prevSibling = to;
+
+			for (Entity::ID child = relationship.firstChild; child != Relationship::NONE; child = mRelationships[child].nextSibling)
+				mRelationships[child].parent = to;
+
+			// relocations always move down, so the new id fits the table
+			mRelationships[to] = relationship;
+			mRelationships[from] = Relationship();
+			isChanged = true;
+		}
+
+		if (isChanged)
+			markChanged();
+	}
+
+	void HierarchyManager::cloneTo(HierarchyManager& target) const
+	{
+		target.mRelationships = mRelationships;
+		target.markChanged();
+	}
+
+	void HierarchyManager::reportMemory(MemoryReport& report) const
+	{
+		for (const auto& relationship : mRelationships)
+			if (relationship.parent != Relationship::NONE || relationship.firstChild != Relationship::NONE)
+				report.hierarchy.live += sizeof(Relationship);
+
+		report.hierarchy.reserved += mRelationships.capacity() * sizeof(Relationship)
+			+ (mDepthFirst.capacity() + mRanks.capacity()) * sizeof(Entity::ID);
+	}
+
+	void HierarchyManager::shrinkToFit()
+	{
+		// trim the table to the last Entity that is in a hierarchy
+		std::size_t size = mRelationships.size();
+		while (size > 0 && mRelationships[size - 1].parent == Relationship::NONE
+			&& mRelationships[size - 1].firstChild == Relationship::NONE)
+			size--;
+
+		mRelationships.resize(size);
+		mRelationships.shrink_to_fit();
+
+		// the order is rebuilt at its new size when it is next used
+		mDepthFirst.clear();
+		mDepthFirst.shrink_to_fit();
+		mRanks.clear();
+		mRanks.shrink_to_fit();
+		markChanged();
+	}
+
+	void HierarchyManager::toString()
+	{
+		using namespace std;
+
+		for (const auto& id : getDepthFirstOrder())
+		{
+			for (Entity::ID parent = mRelationships[id].parent; parent != Relationship::NONE; parent = mRelationships[parent].parent)
+				cout << "\t";
+
+			cout << id << endl;
+		}
+	}
+
+	void HierarchyManager::detach(Entity::ID id)
+	{
+		if (id >= mRelationships.size())
+			return;
+
+		Relationship& relationship = mRelationships[id];
+		if (relationship.parent == Relationship::NONE)
+			return;
+
+		if (relationship.prevSibling != Relationship::NONE)
+			mRelationships[relationship.prevSibling].nextSibling = relationship.nextSibling;
+		else
+			mRelationships[relationship.parent].firstChild = relationship.nextSibling;
+
+		if (relationship.nextSibling != Relationship::NONE)
+			mRelationships[relationship.nextSibling].prevSibling = relationship.prevSibling;
+
+		relationship.parent = Relationship::NONE;
+		relationship.nextSibling = Relationship::NONE;
+		relationship.prevSibling = Relationship::NONE;
+	}
+
+	bool HierarchyManager::isAncestor(Entity::ID ancestor, Entity::ID id) const
+	{
+		for (; id != Relationship::NONE; id = getRelationship(id).parent)
+			if (id == ancestor)
+				return true;
+
+		return false;
+	}
+
+	void HierarchyManager::grow(Entity::ID id)
+	{
+		if (mRelationships.size() <= id)
+			mRelationships.resize(id * 2 + 1);
+	}
+
+	void HierarchyManager::markChanged()
+	{
+		mVersion++;
+		mIsSorted = false;
+	}
+
+	void HierarchyManager::sort()
+	{
+		if (mIsSorted)
+			return;
+
+		mDepthFirst.clear();
+		mRanks.assign(mRelationships.size(), Relationship::NONE);
+
+		for (Entity::ID root = 0; root < mRelationships.size(); root++)
+		{
+			if (mRelationships[root].parent != Relationship::NONE || mRelationships[root].firstChild == Relationship::NONE)
+				continue;
+
+			// walk the tree through its links, down to the first child, then across to
+			// the next sibling, climbing back up when a sibling list ends
+			Entity::ID id = root;
+			while (true)
+			{
+				mRanks[id] = (Entity::ID)mDepthFirst.size();
+				mDepthFirst.push_back(id);
+
+				if (mRelationships[id].firstChild != Relationship::NONE)
+				{
+					id = mRelationships[id].firstChild;
+					continue;
+				}
+
+				while (id != root && mRelationships[id].nextSibling == Relationship::NONE)
+					id = mRelationships[id].parent;
+
+				if (id == root)
+					break;
+
+				id = mRelationships[id].nextSibling;
+			}
+		}
+
+		mIsSorted = true;
+	}
+}
@@ -0,0 +1,161 @@
+#include "MappedSnapshot.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Atlas
+{
+	MappedSnapshot::MappedSnapshot()
+		: mData(nullptr)
+		, mSize(0)
+		, mContents()
+		, mFile(nullptr)
+		, mMapping(nullptr)
+	{
+	}
+
+	MappedSnapshot::MappedSnapshot(const std::string& path)
+		: mData(nullptr)
+		, mSize(0)
+		, mContents()
+		, mFile(nullptr)
+		, mMapping(nullptr)
+	{
+		open(path);
+	}
+
+	MappedSnapshot::~MappedSnapshot()
+	{
+		close();
+	}
+
+	bool MappedSnapshot::open(const std::string& path)
+	{
+		close();
+
+#ifdef _WIN32
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		// PAGE_WRITECOPY with FILE_MAP_COPY gives a private copy on write view
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+		if (mapping == NULL)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+		if (data == NULL)
+		{
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+
+		mFile = file;
+		mMapping = mapping;
+		mData = static_cast<char*>(data);
+		mSize = (std::size_t)size.QuadPart;
+#else
+		int file = ::open(path.c_str(), O_RDONLY);
+		if (file < 0)
+			return false;
+
+		struct stat status;
+		if (fstat(file, &status) != 0 || status.st_size == 0)
+		{
+			::close(file);
+			return false;
+		}
+
+		// MAP_PRIVATE gives a copy on write view, the descriptor is not needed once mapped
+		void* data = mmap(nullptr, (std::size_t)status.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+		::close(file);
+
+		if (data == MAP_FAILED)
+			return false;
+
+		mData = static_cast<char*>(data);
+		mSize = (std::size_t)status.st_size;
+#endif
+
+		if (!Snapshot::parse(mData, mSize, mContents))
+		{
+			close();
+			return false;
+		}
+
+		return true;
+	}
+
+	void MappedSnapshot::close()
+	{
+		if (mData == nullptr)
+			return;
+
+#ifdef _WIN32
+		UnmapViewOfFile(mData);
+		CloseHandle(mMapping);
+		CloseHandle(mFile);
+#else
+		munmap(mData, mSize);
+#endif
+
+		mData = nullptr;
+		mSize = 0;
+		mFile = nullptr;
+		mMapping = nullptr;
+		mContents = SnapshotContents();
+	}
+
+	bool MappedSnapshot::isOpen() const
+	{
+		return mData != nullptr;
+	}
+
+	char* MappedSnapshot::getData()
+	{
+		return mData;
+	}
+
+	const char* MappedSnapshot::getData() const
+	{
+		return mData;
+	}
+
+	std::size_t MappedSnapshot::getSize() const
+	{
+		return mSize;
+	}
+
+	const SnapshotContents& MappedSnapshot::getContents() const
+	{
+		return mContents;
+	}
+
+	const SnapshotBlock* MappedSnapshot::getBlock(const std::string& name) const
+	{
+		for (const auto& block : mContents.blocks)
+			if (block.name == name)
+				return &block;
+
+		return nullptr;
+	}
+}
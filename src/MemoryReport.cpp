@@ -0,0 +1,60 @@
+#include "MemoryReport.h"
+
+#include <iostream>
+
+namespace Atlas
+{
+	MemoryUsage::MemoryUsage()
+		: live(0)
+		, reserved(0)
+	{
+	}
+
+	MemoryUsage& MemoryUsage::operator+=(const MemoryUsage& other)
+	{
+		live += other.live;
+		reserved += other.reserved;
+		return *this;
+	}
+
+	MemoryUsage MemoryReport::total() const
+	{
+		MemoryUsage sum;
+
+		for (const auto& component : components)
+			sum += component.usage;
+
+		sum += entities;
+		sum += systems;
+		sum += groups;
+		sum += hierarchy;
+		sum += fields;
+
+		return sum;
+	}
+
+	void MemoryReport::toString() const
+	{
+		using namespace std;
+
+		cout << "-------------------------------------------------"
+			<< "\n|\t\tMemoryReport\t\t\t|"
+			<< "\n-------------------------------------------------"
+			<< endl;
+
+		for (const auto& component : components)
+		{
+			cout << component.name << " (" << component.count << "): "
+				<< component.usage.live << " live, "
+				<< component.usage.reserved << " reserved" << endl;
+		}
+
+		cout << "Entities: " << entities.live << " live, " << entities.reserved << " reserved"
+			<< "\nSystems: " << systems.live << " live, " << systems.reserved << " reserved"
+			<< "\nGroups: " << groups.live << " live, " << groups.reserved << " reserved"
+			<< "\nHierarchy: " << hierarchy.live << " live, " << hierarchy.reserved << " reserved"
+			<< "\nFields: " << fields.live << " live, " << fields.reserved << " reserved"
+			<< "\nTotal: " << total().live << " live, " << total().reserved << " reserved"
+			<< endl << endl;
+	}
+}
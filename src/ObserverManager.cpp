@@ -0,0 +1,198 @@
+#include "ObserverManager.h"
+#include "World.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+	/** Orders events by Entity::ID */
+	struct LowerID
+	{
+		template <typename T>
+		bool operator()(const T& a, const T& b) const
+		{
+			return a.first < b.first;
+		}
+	};
+}
+
+namespace Atlas
+{
+	ObserverManager::ObserverManager(World& world)
+		: mWorld(world)
+		, mConstructObservers(BITSIZE)
+		, mDestroyObservers(BITSIZE)
+		, mIsObserved()
+		, mIsDispatching(false)
+		, mPending(BITSIZE)
+		, mDispatching()
+		, mIDs()
+		, mComponents()
+	{
+	}
+
+	void ObserverManager::dispatch()
+	{
+		mIsDispatching = true;
+
+		for (unsigned int type = 0; type < mPending.size(); type++)
+		{
+			Events& pending = mPending[type];
+			if (pending.constructed.empty() && pending.destroyed.empty())
+				continue;
+
+			// observers may add and remove Components, those events go to a fresh pending list.
+			// The lists are swapped one by one, VS2013 gives Events no move
+			mDispatching.constructed.swap(pending.constructed);
+			mDispatching.destroyed.swap(pending.destroyed);
+			dispatch(type);
+
+			// releases the destroyed Components
+			mDispatching.constructed.clear();
+			mDispatching.destroyed.clear();
+		}
+
+		mIsDispatching = false;
+	}
+
+	void ObserverManager::remapEntities(const std::vector<Entity::Relocation>& relocations)
+	{
+		if (relocations.empty())
+			return;
+
+		std::vector<Entity::Relocation> sorted(relocations);
+		std::sort(sorted.begin(), sorted.end());
+
+		auto remap = [&sorted](Entity::ID& id)
+		{
+			auto itr = std::lower_bound(sorted.begin(), sorted.end(), Entity::Relocation(id, 0));
+			if (itr != sorted.end() && itr->first == id)
+				id = itr->second;
+		};
+
+		for (auto& events : mPending)
+		{
+			for (auto& event : events.constructed)
+				remap(event.first);
+
+			for (auto& event : events.destroyed)
+				remap(event.first);
+		}
+	}
+
+	void ObserverManager::remapComponents(unsigned int type, const std::vector<Component::Ptr>& from, const std::vector<Component::Ptr>& to)
+	{
+		for (auto& event : mPending[type].constructed)
+			if (event.first < from.size() && from[event.first].get() == event.second)
+				event.second = to[event.first].get();
+	}
+
+	void ObserverManager::clear()
+	{
+		for (auto& events : mPending)
+		{
+			events.constructed.clear();
+			events.destroyed.clear();
+		}
+	}
+
+	void ObserverManager::addObserver(std::vector<std::vector<Observer>>& observers, unsigned int type, Observer observer)
+	{
+		assert(!mIsDispatching && "Observers can not be added while observers are called");
+
+		observers[type].push_back(observer);
+		mIsObserved.set(type);
+	}
+
+	void ObserverManager::removeObservers(unsigned int type)
+	{
+		assert(!mIsDispatching && "Observers can not be removed while observers are called");
+
+		mConstructObservers[type].clear();
+		mDestroyObservers[type].clear();
+		mIsObserved.reset(type);
+
+		mPending[type].constructed.clear();
+		mPending[type].destroyed.clear();
+	}
+
+	void ObserverManager::recordConstructed(unsigned int type, Entity::ID id, Component* component)
+	{
+		// recorded even without construct observers, so a Component removed in the same frame is not reported as destroyed
+		mPending[type].constructed.push_back(std::make_pair(id, component));
+	}
+
+	void ObserverManager::recordDestroyed(unsigned int type, Entity::ID id, Component::Ptr& component)
+	{
+		if (mDestroyObservers[type].empty())
+			return;
+
+		mPending[type].destroyed.push_back(std::make_pair(id, std::move(component)));
+	}
+
+	void ObserverManager::dispatch(unsigned int type)
+	{
+		auto& constructed = mDispatching.constructed;
+		auto& destroyed = mDispatching.destroyed;
+
+		// a Component added and removed again since the last dispatch is not reported,
+		// destroyed Components are still alive so their addresses are not reused
+		if (!constructed.empty() && !destroyed.empty())
+		{
+			mComponents.clear();
+			for (const auto& event : constructed)
+				mComponents.push_back(event.second);
+
+			std::sort(mComponents.begin(), mComponents.end());
+
+			destroyed.erase(std::remove_if(destroyed.begin(), destroyed.end(),
+				[this](const std::pair<Entity::ID, Component::Ptr>& event)
+				{
+					return std::binary_search(mComponents.begin(), mComponents.end(), event.second.get());
+				}), destroyed.end());
+		}
+
+		// only Components the Entities still own are reported as constructed
+		const auto& table = mWorld.getEntityManager().readTable(type);
+
+		constructed.erase(std::remove_if(constructed.begin(), constructed.end(),
+			[&table](const std::pair<Entity::ID, Component*>& event)
+			{
+				return event.first >= table.size() || table[event.first].get() != event.second;
+			}), constructed.end());
+
+		std::sort(constructed.begin(), constructed.end());
+		constructed.erase(std::unique(constructed.begin(), constructed.end()), constructed.end());
+
+		if (!destroyed.empty())
+		{
+			std::sort(destroyed.begin(), destroyed.end(), LowerID());
+
+			mIDs.clear();
+			mComponents.clear();
+			for (const auto& event : destroyed)
+			{
+				mIDs.push_back(event.first);
+				mComponents.push_back(event.second.get());
+			}
+
+			for (const auto& observer : mDestroyObservers[type])
+				observer(mIDs, mComponents);
+		}
+
+		if (!constructed.empty() && !mConstructObservers[type].empty())
+		{
+			mIDs.clear();
+			mComponents.clear();
+			for (const auto& event : constructed)
+			{
+				mIDs.push_back(event.first);
+				mComponents.push_back(event.second);
+			}
+
+			for (const auto& observer : mConstructObservers[type])
+				observer(mIDs, mComponents);
+		}
+	}
+}
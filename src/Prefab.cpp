@@ -0,0 +1,49 @@
+#include "Prefab.h"
+
+namespace Atlas
+{
+	Prefab::Prefab()
+		: mPrototypes()
+		, mComponentBits()
+	{
+	}
+
+	Prefab::Prototype::Prototype(const ComponentIdentifier& identifier, Component::Ptr component)
+		: identifier(&identifier)
+		, component(std::move(component))
+	{
+	}
+
+	Prefab::Prototype::Prototype(Prototype&& other)
+		: identifier(other.identifier)
+		, component(std::move(other.component))
+	{
+	}
+
+	Prefab::Prototype& Prefab::Prototype::operator=(Prototype&& other)
+	{
+		identifier = other.identifier;
+		component = std::move(other.component);
+		return *this;
+	}
+
+	std::bitset<BITSIZE> Prefab::getComponentBits() const
+	{
+		return mComponentBits;
+	}
+
+	void Prefab::setPrototype(const ComponentIdentifier& identifier, Component::Ptr component)
+	{
+		for (auto& prototype : mPrototypes)
+		{
+			if (prototype.identifier == &identifier)
+			{
+				prototype.component = std::move(component);
+				return;
+			}
+		}
+
+		mPrototypes.push_back(Prototype(identifier, std::move(component)));
+		mComponentBits |= identifier.getBit();
+	}
+}
@@ -0,0 +1,243 @@
+#include "Profiler.h"
+
+#include <iostream>
+#include <thread>
+
+// VS2013 has no thread_local; its __declspec(thread) is enough for the plain data cache
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define ATLAS_THREAD_LOCAL __declspec(thread)
+#else
+#define ATLAS_THREAD_LOCAL thread_local
+#endif
+
+namespace Atlas
+{
+	/**
+	* Counters written by a single thread. The counters are atomic so other threads can
+	* read them, but only the owner writes, so a plain load and store is enough.
+	*/
+	struct ProfileBlock
+	{
+		ProfileBlock()
+			: thread(std::this_thread::get_id())
+			, next(nullptr)
+			, countdown(1)
+		{
+			for (unsigned int op = 0; op < Profiler::OPERATION_COUNT; op++)
+			{
+				calls[op].store(0, std::memory_order_relaxed);
+				samples[op].store(0, std::memory_order_relaxed);
+				sampledNanoseconds[op].store(0, std::memory_order_relaxed);
+
+				for (unsigned int type = 0; type < BITSIZE; type++)
+					byType[op][type].store(0, std::memory_order_relaxed);
+			}
+		}
+
+		static void add(std::atomic<unsigned long long>& counter, unsigned long long amount)
+		{
+			counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+		}
+
+		std::thread::id                     thread;
+		ProfileBlock*                       next;
+
+		/** Calls left until the next sampled call */
+		unsigned int                        countdown;
+
+		std::atomic<unsigned long long>     calls[Profiler::OPERATION_COUNT];
+		std::atomic<unsigned long long>     samples[Profiler::OPERATION_COUNT];
+		std::atomic<unsigned long long>     sampledNanoseconds[Profiler::OPERATION_COUNT];
+		std::atomic<unsigned long long>     byType[Profiler::OPERATION_COUNT][BITSIZE];
+	};
+}
+
+namespace
+{
+	/** Source of Profiler serials, 0 is never handed out */
+	std::atomic<unsigned long long> nextSerial(1);
+
+	/** The block the calling thread last counted into, and the Profiler it belongs to */
+	struct BlockCache
+	{
+		unsigned long long          serial;
+		Atlas::ProfileBlock*        block;
+	};
+
+	ATLAS_THREAD_LOCAL BlockCache cache = { 0, nullptr };
+
+	/** Operations that are counted per Component type */
+	bool isTyped(unsigned int operation)
+	{
+		return operation == Atlas::Profiler::ADD_COMPONENT || operation == Atlas::Profiler::REMOVE_COMPONENT;
+	}
+}
+
+namespace Atlas
+{
+	OperationStats::OperationStats()
+		: calls(0)
+		, samples(0)
+		, sampledNanoseconds(0)
+		, byType()
+	{
+	}
+
+	double OperationStats::averageMicroseconds() const
+	{
+		return samples > 0 ? sampledNanoseconds / 1000.0 / samples : 0.0;
+	}
+
+	void ProfileReport::toString() const
+	{
+		using namespace std;
+
+		const char* names[] = { "addComponent", "removeComponent", "createEntity", "reap", "checkInterest" };
+
+		cout << "-------------------------------------------------"
+			<< "\n|\t\tProfile\t\t\t\t|"
+			<< "\n-------------------------------------------------"
+			<< endl;
+
+		for (std::size_t op = 0; op < operations.size(); op++)
+		{
+			cout << names[op] << ": " << operations[op].calls << " calls, "
+				<< operations[op].averageMicroseconds() << " us avg" << endl;
+		}
+
+		cout << endl;
+	}
+
+	Profiler::Scope::Scope(Profiler& profiler, Operation operation, unsigned int type, unsigned long long count)
+		: mBlock(&profiler.getBlock())
+		, mOperation(operation)
+		, mCount(count)
+		, mIsSampled(false)
+		, mStart()
+	{
+		ProfileBlock::add(mBlock->calls[operation], count);
+
+		if (type < BITSIZE)
+			ProfileBlock::add(mBlock->byType[operation][type], count);
+
+		// the first call and then one in SAMPLE_INTERVAL reads the clock
+		if (--mBlock->countdown == 0)
+		{
+			mBlock->countdown = SAMPLE_INTERVAL;
+			mIsSampled = true;
+			mStart = Clock::now();
+		}
+	}
+
+	Profiler::Scope::~Scope()
+	{
+		if (!mIsSampled)
+			return;
+
+		const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - mStart).count();
+
+		ProfileBlock::add(mBlock->samples[mOperation], mCount);
+		ProfileBlock::add(mBlock->sampledNanoseconds[mOperation], static_cast<unsigned long long>(elapsed));
+	}
+
+	Profiler::Profiler()
+		: mSerial(nextSerial.fetch_add(1, std::memory_order_relaxed))
+		, mBlocks(nullptr)
+		, mLast(sum())
+	{
+	}
+
+	Profiler::~Profiler()
+	{
+		ProfileBlock* block = mBlocks.load(std::memory_order_acquire);
+		while (block != nullptr)
+		{
+			ProfileBlock* next = block->next;
+			delete block;
+			block = next;
+		}
+	}
+
+	ProfileReport Profiler::report()
+	{
+		ProfileReport total = sum();
+		ProfileReport frame = total;
+
+		// counters only grow, so the changes are the difference to the last totals
+		for (std::size_t op = 0; op < frame.operations.size(); op++)
+		{
+			OperationStats& stats = frame.operations[op];
+			const OperationStats& last = mLast.operations[op];
+
+			stats.calls -= last.calls;
+			stats.samples -= last.samples;
+			stats.sampledNanoseconds -= last.sampledNanoseconds;
+
+			for (std::size_t type = 0; type < stats.byType.size(); type++)
+				stats.byType[type] -= last.byType[type];
+		}
+
+		mLast = std::move(total);
+		return frame;
+	}
+
+	ProfileBlock& Profiler::getBlock()
+	{
+		// a thread usually counts into a single World, so the last block is almost always the one
+		if (cache.serial == mSerial)
+			return *cache.block;
+
+		return findBlock();
+	}
+
+	ProfileBlock& Profiler::findBlock()
+	{
+		const std::thread::id thread = std::this_thread::get_id();
+
+		ProfileBlock* block = mBlocks.load(std::memory_order_acquire);
+		while (block != nullptr && block->thread != thread)
+			block = block->next;
+
+		// only this thread adds its block, so it can not have been added since the search
+		if (block == nullptr)
+		{
+			block = new ProfileBlock();
+			block->next = mBlocks.load(std::memory_order_relaxed);
+
+			while (!mBlocks.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed))
+			{
+			}
+		}
+
+		cache.serial = mSerial;
+		cache.block = block;
+
+		return *block;
+	}
+
+	ProfileReport Profiler::sum() const
+	{
+		ProfileReport report;
+		report.operations.resize(OPERATION_COUNT);
+
+		for (unsigned int op = 0; op < OPERATION_COUNT; op++)
+			if (isTyped(op))
+				report.operations[op].byType.resize(BITSIZE, 0);
+
+		for (const ProfileBlock* block = mBlocks.load(std::memory_order_acquire); block != nullptr; block = block->next)
+		{
+			for (unsigned int op = 0; op < OPERATION_COUNT; op++)
+			{
+				OperationStats& stats = report.operations[op];
+				stats.calls += block->calls[op].load(std::memory_order_relaxed);
+				stats.samples += block->samples[op].load(std::memory_order_relaxed);
+				stats.sampledNanoseconds += block->sampledNanoseconds[op].load(std::memory_order_relaxed);
+
+				for (std::size_t type = 0; type < stats.byType.size(); type++)
+					stats.byType[type] += block->byType[op][type].load(std::memory_order_relaxed);
+			}
+		}
+
+		return report;
+	}
+}
@@ -0,0 +1,135 @@
+#include "Query.h"
+#include "System.h"
+#include "HierarchyManager.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+namespace Atlas
+{
+	const std::uint32_t Query::NONE;
+
+	bool Signature::matches(const std::bitset<BITSIZE>& componentBits) const
+	{
+		// required bits must be set and excluded bits clear, so masking with both
+		// must leave exactly the required bits
+		return (componentBits & (required | excluded)) == required;
+	}
+
+	bool Signature::selectsSame(const Signature& other) const
+	{
+		return required == other.required && excluded == other.excluded;
+	}
+
+	Query::Query(const Signature& signature)
+		: mSignature(signature)
+		, mMask(signature.required | signature.excluded)
+		, mEntities()
+		, mPositions()
+		, mSystems()
+		, mIsSorted(false)
+		, mSortedVersion(0)
+	{
+	}
+
+	const std::vector<Entity::ID>& Query::getEntities() const
+	{
+		return mEntities;
+	}
+
+	bool Query::contains(Entity::ID id) const
+	{
+		return id < mPositions.size() && mPositions[id] != NONE;
+	}
+
+	const Signature& Query::getSignature() const
+	{
+		return mSignature;
+	}
+
+	void Query::checkInterest(Entity& entity)
+	{
+		const bool contains = this->contains(entity.getID());
+		const bool interest = matches(entity.getComponentBits());
+
+		if (!contains && interest)
+			add(entity);
+		else if (contains && !interest)
+			remove(entity);
+	}
+
+	void Query::add(Entity& entity)
+	{
+		const Entity::ID id = entity.getID();
+
+		// make sure the id fits the container
+		if (mPositions.size() <= id)
+			mPositions.resize(id * 2 + 1, NONE);
+
+		mPositions[id] = static_cast<std::uint32_t>(mEntities.size());
+		mEntities.push_back(id);
+		mIsSorted = false;
+
+		for (auto& system : mSystems)
+		{
+			entity.setSystemBit(system->mSystemBits);
+			system->entityAdded(entity);
+		}
+	}
+
+	void Query::remove(Entity& entity)
+	{
+		const Entity::ID id = entity.getID();
+		const std::uint32_t position = mPositions[id];
+
+		// fill the gap with the last Entity in the list
+		mEntities[position] = mEntities.back();
+		mPositions[mEntities[position]] = position;
+		mEntities.pop_back();
+		mPositions[id] = NONE;
+		mIsSorted = false;
+
+		for (auto& system : mSystems)
+		{
+			entity.removeSystemBit(system->mSystemBits);
+			system->entityRemoved(entity);
+		}
+	}
+
+	void Query::sortDepthFirst(HierarchyManager& hierarchy)
+	{
+		if (mIsSorted && mSortedVersion == hierarchy.getVersion())
+			return;
+
+		hierarchy.sortDepthFirst(mEntities);
+		updatePositions();
+
+		mIsSorted = true;
+		mSortedVersion = hierarchy.getVersion();
+	}
+
+	void Query::updatePositions()
+	{
+		for (std::size_t i = 0; i < mEntities.size(); i++)
+			mPositions[mEntities[i]] = static_cast<std::uint32_t>(i);
+	}
+
+	bool Query::matches(const std::bitset<BITSIZE>& componentBits) const
+	{
+		return (componentBits & mMask) == mSignature.required;
+	}
+
+	void Query::toString()
+	{
+		using namespace std;
+
+		cout << "Query Entities: ";
+		for (const auto& e : mEntities)
+			cout << e << ", ";
+
+		cout << "\nRequired: " << mSignature.required
+			<< "\nExcluded: " << mSignature.excluded
+			<< "\nShared by " << mSystems.size() << " Systems" << endl << endl;
+	}
+}
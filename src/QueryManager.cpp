@@ -0,0 +1,225 @@
+#include "QueryManager.h"
+#include "World.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+namespace Atlas
+{
+	QueryManager::QueryManager(World& world)
+		: mWorld(world)
+		, mQueries()
+		, mMatches()
+	{
+	}
+
+	const Query& QueryManager::getQuery(const Signature& signature)
+	{
+		return findOrCreate(signature);
+	}
+
+	void QueryManager::checkInterest(Entity& entity)
+	{
+		for (auto& query : mQueries)
+			query->checkInterest(entity);
+	}
+
+	void QueryManager::addEntities(const std::bitset<BITSIZE>& componentBits, const std::vector<Entity::ID>& ids)
+	{
+		EntityManager& eManager = mWorld.getEntityManager();
+
+		for (auto& query : mQueries)
+		{
+			if (!query->matches(componentBits))
+				continue;
+
+			query->mEntities.reserve(query->mEntities.size() + ids.size());
+
+			for (const auto& id : ids)
+				query->add(eManager.getEntity(id));
+		}
+	}
+
+	void QueryManager::attach(System& system)
+	{
+		Query& query = findOrCreate(system.mSignature);
+		query.mSystems.push_back(&system);
+		system.mQuery = &query;
+
+		EntityManager& eManager = mWorld.getEntityManager();
+		for (const auto& id : query.mEntities)
+		{
+			Entity& entity = eManager.getEntity(id);
+			entity.setSystemBit(system.mSystemBits);
+			system.entityAdded(entity);
+		}
+	}
+
+	void QueryManager::rebuild()
+	{
+		EntityManager& eManager = mWorld.getEntityManager();
+
+		for (auto& query : mQueries)
+		{
+			// walk backwards, as removing an Entity moves the last one into its place
+			for (std::size_t i = query->mEntities.size(); i-- > 0;)
+			{
+				Entity& entity = eManager.getEntity(query->mEntities[i]);
+				if (!query->matches(entity.getComponentBits()))
+					query->remove(entity);
+			}
+
+			eManager.findMatching(query->mSignature, mMatches);
+
+			for (const auto& id : mMatches)
+				if (!query->contains(id))
+					query->add(eManager.getEntity(id));
+		}
+	}
+
+	void QueryManager::remapEntities(const std::vector<Entity::Relocation>& relocations)
+	{
+		for (auto& query : mQueries)
+		{
+			for (const auto& relocation : relocations)
+			{
+				const auto& from = relocation.first;
+				const auto& to = relocation.second;
+
+				if (!query->contains(from))
+					continue;
+
+				// relocations always move down, so the new id fits the table
+				const std::uint32_t position = query->mPositions[from];
+				query->mEntities[position] = to;
+				query->mPositions[to] = position;
+				query->mPositions[from] = Query::NONE;
+			}
+
+			for (auto& system : query->mSystems)
+			{
+				system->remapPass(relocations);
+				system->entitiesRemapped(relocations);
+			}
+		}
+	}
+
+	void QueryManager::sortEntities()
+	{
+		for (auto& query : mQueries)
+		{
+			std::sort(query->mEntities.begin(), query->mEntities.end());
+			query->updatePositions();
+			query->mIsSorted = false;
+		}
+	}
+
+	void QueryManager::cloneTo(QueryManager& target) const
+	{
+		assert(&target != this);
+		EntityManager& eManager = target.mWorld.getEntityManager();
+
+		for (auto& query : target.mQueries)
+		{
+			auto match = std::find_if(mQueries.begin(), mQueries.end(), [&query](const std::unique_ptr<Query>& q)
+			{
+				return q->mSignature.selectsSame(query->mSignature);
+			});
+
+			if (match != mQueries.end())
+			{
+				query->mEntities = (*match)->mEntities;
+				query->mPositions = (*match)->mPositions;
+			}
+			else
+			{
+				target.fill(*query);
+			}
+
+			query->mIsSorted = false;
+
+			for (auto& system : query->mSystems)
+			{
+				for (const auto& id : query->mEntities)
+					eManager.getEntity(id).setSystemBit(system->mSystemBits);
+
+				// time sliced passes start over on the new Entities
+				system->mSchedule.pass.clear();
+				system->mSchedule.cursor = 0;
+
+				system->entitiesReplaced();
+			}
+		}
+	}
+
+	void QueryManager::reportMemory(MemoryReport& report) const
+	{
+		report.systems.reserved += mQueries.capacity() * sizeof(std::unique_ptr<Query>);
+
+		for (const auto& query : mQueries)
+		{
+			report.systems.live += sizeof(Query) + query->mEntities.size() * (sizeof(Entity::ID) + sizeof(std::uint32_t));
+			report.systems.reserved += sizeof(Query) + query->mEntities.capacity() * sizeof(Entity::ID)
+				+ query->mPositions.capacity() * sizeof(std::uint32_t)
+				+ query->mSystems.capacity() * sizeof(System*);
+		}
+	}
+
+	void QueryManager::shrinkToFit()
+	{
+		for (auto& query : mQueries)
+		{
+			// trim the position table to the highest Entity in the Query
+			Entity::ID highest = 0;
+			for (const auto& id : query->mEntities)
+				highest = std::max(highest, id + 1);
+
+			query->mPositions.resize(highest);
+			query->mPositions.shrink_to_fit();
+			query->mEntities.shrink_to_fit();
+		}
+	}
+
+	void QueryManager::toString()
+	{
+		using namespace std;
+
+		cout << "-------------------------------------------------"
+			<< "\n|\t\tQueryManager\t\t\t|"
+			<< "\n-------------------------------------------------"
+			<< endl;
+
+		cout << "Cached Queries: " << mQueries.size() << endl;
+
+		for (const auto& query : mQueries)
+			query->toString();
+
+		cout << endl;
+	}
+
+	Query& QueryManager::findOrCreate(const Signature& signature)
+	{
+		for (auto& query : mQueries)
+			if (query->mSignature.selectsSame(signature))
+				return *query;
+
+		mQueries.push_back(std::unique_ptr<Query>(new Query(signature)));
+		fill(*mQueries.back());
+
+		return *mQueries.back();
+	}
+
+	void QueryManager::fill(Query& query)
+	{
+		mWorld.getEntityManager().findMatching(query.mSignature, query.mEntities);
+		query.mPositions.clear();
+
+		if (!query.mEntities.empty())
+			query.mPositions.resize(query.mEntities.back() + 1, Query::NONE);
+
+		// matches are in ascending order, so the list starts out sorted by ID
+		for (std::size_t position = 0; position < query.mEntities.size(); position++)
+			query.mPositions[query.mEntities[position]] = static_cast<std::uint32_t>(position);
+	}
+}
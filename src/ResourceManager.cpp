@@ -0,0 +1,51 @@
+#include "ResourceManager.h"
+
+namespace
+{
+	/** Indices of resource types, shared by every World and created by the first lookup */
+	std::once_flag registryFlag;
+	Atlas::TypeRegistry<unsigned int>* registry = nullptr;
+
+	Atlas::TypeRegistry<unsigned int>& getRegistry()
+	{
+		return Atlas::TypeRegistry<unsigned int>::getShared(registryFlag, registry);
+	}
+}
+
+namespace Atlas
+{
+	ResourceManager::ResourceManager()
+		: mSlots(BITSIZE)
+	{
+	}
+
+	void ResourceManager::cloneTo(ResourceManager& target) const
+	{
+		for (std::size_t index = 0; index < mSlots.size(); index++)
+		{
+			if (mSlots[index].resource == nullptr)
+				continue;
+
+			void* data = nullptr;
+			Resource::Ptr copy = mSlots[index].resource->clone(data);
+
+			if (copy != nullptr)
+				target.setSlot(static_cast<unsigned int>(index), std::move(copy), data);
+		}
+	}
+
+	unsigned int ResourceManager::getIndex(const std::type_index& type)
+	{
+		return getRegistry().findOrAdd(type, [](std::size_t index)
+		{
+			return static_cast<unsigned int>(index);
+		});
+	}
+
+	void ResourceManager::setSlot(unsigned int index, Resource::Ptr resource, void* data)
+	{
+		Slot& slot = mSlots[index];
+		slot.resource = std::move(resource);
+		slot.data = data;
+	}
+}
@@ -0,0 +1,56 @@
+#include "Schedule.h"
+
+namespace Atlas
+{
+	EntityRange::EntityRange(const Entity::ID* begin, const Entity::ID* end)
+		: mBegin(begin)
+		, mEnd(end)
+	{
+	}
+
+	const Entity::ID* EntityRange::begin() const
+	{
+		return mBegin;
+	}
+
+	const Entity::ID* EntityRange::end() const
+	{
+		return mEnd;
+	}
+
+	std::size_t EntityRange::size() const
+	{
+		return static_cast<std::size_t>(mEnd - mBegin);
+	}
+
+	ScheduleStats::ScheduleStats()
+		: runs(0)
+		, overruns(0)
+		, droppedSteps(0)
+		, lastMicroseconds(0.0)
+		, maxMicroseconds(0.0)
+	{
+	}
+
+	Schedule::Schedule()
+		: mode(EVERY_FRAME)
+		, interval(0.0f)
+		, maxSteps(1)
+		, slices(1)
+		, budget(0.0)
+		, accumulator(0.0f)
+		, slice(0)
+		, sliceElapsed(1, 0.0f)
+		, isTimeSliced(false)
+		, timeSlice(0.0)
+		, pass()
+		, cursor(0)
+		, processed(0)
+		, start()
+		, deadline()
+		, isAsync(false)
+		, task()
+		, waited(0.0f)
+	{
+	}
+}
@@ -0,0 +1,509 @@
+#include "Snapshot.h"
+#include "World.h"
+#include "ComponentIdentifierManager.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+	const char MAGIC[4] = { 'A', 'T', 'L', 'S' };
+
+	static_assert(sizeof(Atlas::Entity::ID) == sizeof(std::uint32_t), "Snapshots store Entity::IDs as 32 bit values");
+
+	/** Checks that every ID is marked active */
+	bool areActive(const std::uint32_t* ids, std::size_t count, const std::vector<bool>& isActive)
+	{
+		for (std::size_t i = 0; i < count; i++)
+			if (!isActive[ids[i]])
+				return false;
+
+		return true;
+	}
+}
+
+namespace Atlas
+{
+	SnapshotWriter::SnapshotWriter(std::vector<char>& buffer)
+		: mBuffer(buffer)
+	{
+	}
+
+	void SnapshotWriter::write(const void* data, std::size_t size)
+	{
+		if (size == 0)
+			return;
+
+		const std::size_t offset = reserve(size);
+		std::memcpy(&mBuffer[offset], data, size);
+	}
+
+	void SnapshotWriter::writeUInt(std::uint32_t value)
+	{
+		write(&value, sizeof(value));
+	}
+
+	void SnapshotWriter::writeString(const std::string& value)
+	{
+		writeUInt((std::uint32_t)value.size());
+		write(value.data(), value.size());
+	}
+
+	void SnapshotWriter::writeArray(const std::uint32_t* values, std::size_t count)
+	{
+		writeUInt((std::uint32_t)count);
+		align(Snapshot::ALIGNMENT);
+		write(values, count * sizeof(std::uint32_t));
+	}
+
+	std::size_t SnapshotWriter::reserve(std::size_t size)
+	{
+		const std::size_t offset = mBuffer.size();
+		mBuffer.resize(offset + size);
+		return offset;
+	}
+
+	void SnapshotWriter::align(std::size_t alignment)
+	{
+		const std::size_t remainder = mBuffer.size() % alignment;
+
+		if (remainder != 0)
+			mBuffer.resize(mBuffer.size() + alignment - remainder, 0);
+	}
+
+	std::vector<char>& SnapshotWriter::getBuffer()
+	{
+		return mBuffer;
+	}
+
+	SnapshotReader::SnapshotReader(const char* data, std::size_t size)
+		: mData(data)
+		, mSize(size)
+		, mOffset(0)
+		, mIsValid(true)
+	{
+	}
+
+	bool SnapshotReader::read(void* data, std::size_t size)
+	{
+		const char* source = skip(size);
+
+		if (source != nullptr && size > 0)
+			std::memcpy(data, source, size);
+
+		return source != nullptr;
+	}
+
+	std::uint32_t SnapshotReader::readUInt()
+	{
+		std::uint32_t value = 0;
+		read(&value, sizeof(value));
+		return value;
+	}
+
+	std::string SnapshotReader::readString()
+	{
+		const std::uint32_t size = readUInt();
+		const char* data = skip(size);
+
+		return data != nullptr ? std::string(data, size) : std::string();
+	}
+
+	const std::uint32_t* SnapshotReader::readArray(std::uint32_t limit, std::size_t& count)
+	{
+		count = readUInt();
+		align(Snapshot::ALIGNMENT);
+
+		// checked before multiplying, so a large count can not wrap a 32 bit size
+		if (!mIsValid || count > (mSize - mOffset) / sizeof(std::uint32_t))
+		{
+			mIsValid = false;
+			return nullptr;
+		}
+
+		const std::uint32_t* values = reinterpret_cast<const std::uint32_t*>(skip(count * sizeof(std::uint32_t)));
+		if (values == nullptr)
+			return nullptr;
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			if (values[i] >= limit || (i > 0 && values[i] <= values[i - 1]))
+			{
+				mIsValid = false;
+				return nullptr;
+			}
+		}
+
+		return values;
+	}
+
+	const char* SnapshotReader::skip(std::size_t size)
+	{
+		if (!mIsValid || mSize - mOffset < size)
+		{
+			mIsValid = false;
+			return nullptr;
+		}
+
+		const char* data = mData + mOffset;
+		mOffset += size;
+
+		return data;
+	}
+
+	void SnapshotReader::align(std::size_t alignment)
+	{
+		const std::size_t remainder = mOffset % alignment;
+
+		if (remainder != 0)
+			skip(alignment - remainder);
+	}
+
+	bool SnapshotReader::isValid() const
+	{
+		return mIsValid;
+	}
+
+	void Snapshot::registerType(const std::type_index& index, std::size_t size, std::size_t dataSize,
+		CreateFunction create, SaveFunction save, LoadFunction load, SaveFieldsFunction saveFields, LoadFieldsFunction loadFields)
+	{
+		const ComponentIdentifier& identifier = ComponentIdentifierManager::getType(index, size);
+
+		if (mSerializers.size() <= identifier.getID())
+			mSerializers.resize(BITSIZE);
+
+		Serializer& serializer = mSerializers[identifier.getID()];
+		serializer.identifier = &identifier;
+		serializer.name = identifier.getName();
+		serializer.dataSize = dataSize;
+		serializer.create = create;
+		serializer.save = save;
+		serializer.load = load;
+		serializer.saveFields = saveFields;
+		serializer.loadFields = loadFields;
+	}
+
+	Component::Ptr Snapshot::readComponent(const Serializer& serializer, FieldManager& fManager, Entity::ID id,
+		const char*& source, SnapshotReader& entries)
+	{
+		Component::Ptr component;
+
+		if (serializer.dataSize > 0)
+		{
+			component.reset(serializer.create());
+
+			if (serializer.loadFields != nullptr)
+				serializer.loadFields(fManager, id, source);
+			else
+				std::memcpy(reinterpret_cast<char*>(component.get()) + sizeof(Component), source, serializer.dataSize);
+
+			source += serializer.dataSize;
+		}
+		else
+		{
+			const std::uint32_t entrySize = entries.readUInt();
+			SnapshotReader entry(entries.skip(entrySize), entrySize);
+			component = serializer.load(entry);
+		}
+
+		return component;
+	}
+
+	unsigned int Snapshot::findType(const std::string& name)
+	{
+		for (unsigned int i = 0; i < mSerializers.size(); i++)
+			if (!mSerializers[i].name.empty() && mSerializers[i].name == name)
+				return i;
+
+		return BITSIZE;
+	}
+
+	std::vector<char> Snapshot::save(World& world)
+	{
+		const EntityManager& eManager = world.getEntityManager();
+		const GroupManager& gManager = world.getGroupManager();
+		FieldManager& fManager = world.getFieldManager();
+
+		std::vector<char> buffer;
+		SnapshotWriter writer(buffer);
+
+		writer.write(MAGIC, sizeof(MAGIC));
+		writer.writeUInt(VERSION);
+
+		// Entity table, every ID below the next new ID is listed as active or dead
+		std::vector<std::uint32_t> ids;
+		std::vector<std::uint32_t> dead;
+		const Entity::ID nextID = eManager.mNextAvaibleID;
+		for (Entity::ID id = 0; id < nextID; id++)
+		{
+			if (id < eManager.mActiveEntities.size() && eManager.mActiveEntities[id] != nullptr
+				&& eManager.mActiveEntities[id]->isActive())
+				ids.push_back(id);
+			else
+				dead.push_back(id);
+		}
+
+		writer.writeUInt(nextID);
+		writer.writeArray(ids.data(), ids.size());
+		writer.writeArray(dead.data(), dead.size());
+
+		// one block per registered Component type
+		std::uint32_t typeCount = 0;
+		for (const auto& serializer : mSerializers)
+			if (!serializer.name.empty())
+				typeCount++;
+
+		writer.writeUInt(typeCount);
+
+		std::vector<const Component*> components;
+		for (unsigned int type = 0; type < mSerializers.size(); type++)
+		{
+			const Serializer& serializer = mSerializers[type];
+			if (serializer.name.empty())
+				continue;
+
+			const auto& typeComponents = eManager.readTable(type);
+
+			ids.clear();
+			components.clear();
+			for (std::size_t id = 0; id < typeComponents.size(); id++)
+			{
+				if (typeComponents[id] != nullptr && eManager.mActiveEntities[id]->isActive())
+				{
+					ids.push_back((std::uint32_t)id);
+					components.push_back(typeComponents[id].get());
+				}
+			}
+
+			writer.writeString(serializer.name);
+			writer.writeUInt((std::uint32_t)serializer.dataSize);
+			writer.writeArray(ids.data(), ids.size());
+			writer.align(ALIGNMENT);
+
+			if (serializer.dataSize > 0)
+			{
+				// plain data, members are packed back to back
+				const std::size_t offset = writer.reserve(serializer.dataSize * components.size());
+				char* data = &buffer[offset];
+
+				for (std::size_t i = 0; i < components.size(); i++)
+				{
+					if (serializer.saveFields != nullptr)
+						serializer.saveFields(fManager, ids[i], data);
+					else
+						std::memcpy(data, reinterpret_cast<const char*>(components[i]) + sizeof(Component), serializer.dataSize);
+
+					data += serializer.dataSize;
+				}
+			}
+			else
+			{
+				// size prefixed hook output, so unknown types can be skipped on load
+				for (const auto& component : components)
+				{
+					const std::size_t offset = writer.reserve(sizeof(std::uint32_t));
+					serializer.save(*component, writer);
+
+					const std::uint32_t size = (std::uint32_t)(buffer.size() - offset - sizeof(std::uint32_t));
+					std::memcpy(&buffer[offset], &size, sizeof(size));
+				}
+			}
+		}
+
+		// groups, Entities set inactive but not yet removed are left out as in the Entity table
+		std::vector<std::pair<const std::string*, std::vector<std::uint32_t>>> groups;
+		for (const auto& group : gManager.mGroupsByName)
+		{
+			std::vector<std::uint32_t> members;
+			for (const auto& id : group.second)
+				if (eManager.mActiveEntities[id]->isActive())
+					members.push_back(id);
+
+			if (members.empty())
+				continue;
+
+			std::sort(members.begin(), members.end());
+			groups.push_back(std::make_pair(&group.first, std::move(members)));
+		}
+
+		writer.writeUInt((std::uint32_t)groups.size());
+
+		for (const auto& group : groups)
+		{
+			writer.writeString(*group.first);
+			writer.writeArray(group.second.data(), group.second.size());
+		}
+
+		return buffer;
+	}
+
+	bool Snapshot::parse(const char* data, std::size_t size, SnapshotContents& contents)
+	{
+		SnapshotReader reader(data, size);
+
+		char magic[sizeof(MAGIC)];
+		if (!reader.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+			return false;
+
+		if (reader.readUInt() != VERSION)
+			return false;
+
+		// Entity table
+		contents.nextID = reader.readUInt();
+		contents.entities = reader.readArray(contents.nextID, contents.entityCount);
+
+		// the dead IDs are listed too, so the Entities a load creates are bounded by the size of the data
+		std::size_t deadCount = 0;
+		const std::uint32_t* dead = reader.readArray(contents.nextID, deadCount);
+
+		if (contents.entities == nullptr || dead == nullptr || contents.entityCount + deadCount != contents.nextID)
+			return false;
+
+		std::vector<bool> isActive(contents.nextID, false);
+		for (std::size_t i = 0; i < contents.entityCount; i++)
+			isActive[contents.entities[i]] = true;
+
+		for (std::size_t i = 0; i < deadCount; i++)
+			if (isActive[dead[i]])
+				return false;
+
+		// Component blocks
+		contents.blocks.clear();
+		const std::uint32_t typeCount = reader.readUInt();
+
+		for (std::uint32_t i = 0; i < typeCount && reader.isValid(); i++)
+		{
+			SnapshotBlock block;
+			block.name = reader.readString();
+			block.dataSize = reader.readUInt();
+			block.owners = reader.readArray(contents.nextID, block.count);
+
+			if (block.owners == nullptr || !areActive(block.owners, block.count, isActive))
+				return false;
+
+			reader.align(ALIGNMENT);
+
+			// plain data block, or a block of size prefixed entries
+			if (block.dataSize > 0)
+			{
+				// the entries can not be larger than the data, checked before multiplying
+				if (block.count > size / block.dataSize)
+					return false;
+
+				block.size = block.dataSize * block.count;
+				block.data = reader.skip(block.size);
+			}
+			else
+			{
+				block.data = reader.skip(0);
+				block.size = 0;
+
+				for (std::size_t j = 0; j < block.count && reader.isValid(); j++)
+				{
+					const std::uint32_t entrySize = reader.readUInt();
+					reader.skip(entrySize);
+					block.size += entrySize + sizeof(std::uint32_t);
+				}
+			}
+
+			contents.blocks.push_back(block);
+		}
+
+		// groups
+		contents.groups.clear();
+		const std::uint32_t groupCount = reader.readUInt();
+
+		for (std::uint32_t i = 0; i < groupCount && reader.isValid(); i++)
+		{
+			SnapshotGroup group;
+			group.name = reader.readString();
+			group.members = reader.readArray(contents.nextID, group.count);
+
+			if (group.members == nullptr || !areActive(group.members, group.count, isActive))
+				return false;
+
+			contents.groups.push_back(group);
+		}
+
+		return reader.isValid();
+	}
+
+	bool Snapshot::load(World& world, const char* data, std::size_t size)
+	{
+		// read and validate everything before the World is touched
+		SnapshotContents contents;
+		if (!parse(data, size, contents))
+			return false;
+
+		return load(world, contents);
+	}
+
+	bool Snapshot::load(World& world, const SnapshotContents& contents)
+	{
+		EntityManager& eManager = world.getEntityManager();
+		GroupManager& gManager = world.getGroupManager();
+		FieldManager& fManager = world.getFieldManager();
+
+		eManager.clear();
+		eManager.restoreEntities(contents.entities, contents.entityCount, contents.nextID);
+
+		for (const auto& block : contents.blocks)
+		{
+			// skip Component types that are not registered, or were registered differently
+			const unsigned int type = findType(block.name);
+			if (type >= BITSIZE || block.dataSize != mSerializers[type].dataSize || block.count == 0)
+				continue;
+
+			const Serializer& serializer = mSerializers[type];
+			const ComponentIdentifier& identifier = *serializer.identifier;
+
+			eManager.reserveComponents(identifier, block.owners[block.count - 1] + 1);
+
+			SnapshotReader entries(block.data, block.size);
+			const char* source = block.data;
+
+			for (std::size_t i = 0; i < block.count; i++)
+			{
+				Component::Ptr component = readComponent(serializer, fManager, block.owners[i], source, entries);
+
+				if (component != nullptr)
+					eManager.attachComponent(eManager.getEntity(block.owners[i]), identifier, std::move(component));
+			}
+		}
+
+		for (const auto& group : contents.groups)
+			for (std::size_t i = 0; i < group.count; i++)
+				gManager.addToGroup(group.name, eManager.getEntity(group.members[i]));
+
+		// one sweep per Query instead of an interest check per Component
+		world.getQueryManager().rebuild();
+
+		return true;
+	}
+
+	bool Snapshot::saveToFile(World& world, const std::string& path)
+	{
+		const std::vector<char> data = save(world);
+
+		std::ofstream file(path.c_str(), std::ios::binary);
+		file.write(data.data(), data.size());
+
+		return file.good();
+	}
+
+	bool Snapshot::loadFromFile(World& world, const std::string& path)
+	{
+		std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+		if (!file)
+			return false;
+
+		std::vector<char> data((std::size_t)file.tellg());
+		file.seekg(0);
+		file.read(data.data(), data.size());
+
+		return file.good() && load(world, data.data(), data.size());
+	}
+
+	std::vector<Snapshot::Serializer> Snapshot::mSerializers;
+}
@@ -0,0 +1,750 @@
+#include "SnapshotDelta.h"
+#include "World.h"
+#include "ComponentIdentifierManager.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace
+{
+	const char MAGIC[4] = { 'A', 'T', 'L', 'D' };
+
+	/** Longest run of bytes described by a single token */
+	const std::size_t MAX_RUN = 128;
+
+	/** Token flag for a run of unchanged bytes, otherwise the token is followed by XORed bytes */
+	const unsigned char UNCHANGED = 0x80;
+
+	/**
+	* Writes the XOR of two entries as runs. Runs of unchanged bytes are a single token,
+	* runs of changed bytes are a token followed by the XORed bytes.
+	*/
+	void writeXorRuns(const char* from, const char* to, std::size_t size, Atlas::SnapshotWriter& writer)
+	{
+		char changed[MAX_RUN];
+		std::size_t i = 0;
+
+		while (i < size)
+		{
+			std::size_t length = 0;
+
+			while (i + length < size && length < MAX_RUN && from[i + length] == to[i + length])
+				length++;
+
+			if (length > 0)
+			{
+				const unsigned char token = (unsigned char)(UNCHANGED | (length - 1));
+				writer.write(&token, 1);
+				i += length;
+				continue;
+			}
+
+			// single unchanged bytes between changes are cheaper inside the run
+			while (i + length < size && length < MAX_RUN)
+			{
+				const std::size_t j = i + length;
+				if (from[j] == to[j] && (j + 1 == size || from[j + 1] == to[j + 1]))
+					break;
+
+				changed[length++] = from[j] ^ to[j];
+			}
+
+			const unsigned char token = (unsigned char)(length - 1);
+			writer.write(&token, 1);
+			writer.write(changed, length);
+			i += length;
+		}
+	}
+
+	/**
+	* Walks the runs for one entry.
+	* @return The end of the runs, or nullptr if they are malformed
+	*/
+	const char* skipXorRuns(const char* runs, const char* end, std::size_t size)
+	{
+		std::size_t covered = 0;
+
+		while (covered < size)
+		{
+			if (runs == end)
+				return nullptr;
+
+			const unsigned char token = *runs++;
+			const std::size_t length = (token & ~UNCHANGED) + 1;
+
+			if ((token & UNCHANGED) == 0)
+			{
+				if ((std::size_t)(end - runs) < length)
+					return nullptr;
+
+				runs += length;
+			}
+
+			covered += length;
+		}
+
+		return covered == size ? runs : nullptr;
+	}
+
+	/**
+	* XORs the runs for one entry into its bytes.
+	* @return The end of the runs
+	*/
+	const char* applyXorRuns(char* target, const char* runs, std::size_t size)
+	{
+		std::size_t offset = 0;
+
+		while (offset < size)
+		{
+			const unsigned char token = *runs++;
+			const std::size_t length = (token & ~UNCHANGED) + 1;
+
+			if ((token & UNCHANGED) == 0)
+			{
+				for (std::size_t i = 0; i < length; i++)
+					target[offset + i] ^= runs[i];
+
+				runs += length;
+			}
+
+			offset += length;
+		}
+
+		return runs;
+	}
+
+	/** Locates each entry of a snapshot block */
+	void findEntries(const Atlas::SnapshotBlock& block, std::vector<const char*>& entries, std::vector<std::uint32_t>& sizes)
+	{
+		const char* entry = block.data;
+
+		for (std::size_t i = 0; i < block.count; i++)
+		{
+			std::uint32_t size = (std::uint32_t)block.dataSize;
+
+			if (block.dataSize == 0)
+			{
+				std::memcpy(&size, entry, sizeof(size));
+				entry += sizeof(size);
+			}
+
+			entries.push_back(entry);
+			sizes.push_back(size);
+			entry += size;
+		}
+	}
+
+	/** Skips a run of plain data or size prefixed entries */
+	const char* skipEntries(Atlas::SnapshotReader& reader, std::size_t dataSize, std::size_t count, std::size_t& size)
+	{
+		if (dataSize > 0)
+		{
+			size = dataSize * count;
+			return reader.skip(size);
+		}
+
+		const char* data = reader.skip(0);
+		size = 0;
+
+		for (std::size_t i = 0; i < count && reader.isValid(); i++)
+		{
+			const std::uint32_t entrySize = reader.readUInt();
+			reader.skip(entrySize);
+			size += entrySize + sizeof(std::uint32_t);
+		}
+
+		return reader.isValid() ? data : nullptr;
+	}
+
+	const Atlas::SnapshotBlock* findBlock(const Atlas::SnapshotContents& contents, const std::string& name, std::size_t dataSize)
+	{
+		for (const auto& block : contents.blocks)
+			if (block.name == name && block.dataSize == dataSize)
+				return &block;
+
+		return nullptr;
+	}
+
+	const Atlas::SnapshotGroup* findGroup(const Atlas::SnapshotContents& contents, const std::string& name)
+	{
+		for (const auto& group : contents.groups)
+			if (group.name == name)
+				return &group;
+
+		return nullptr;
+	}
+
+	/** FNV-1a over a range of bytes, continuing from a previous value */
+	std::uint32_t checksum(const void* data, std::size_t size, std::uint32_t value = 2166136261u)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (std::size_t i = 0; i < size; i++)
+			value = (value ^ bytes[i]) * 16777619u;
+
+		return value;
+	}
+
+	/** Checksum of the owners and entries of a Component block */
+	std::uint32_t checksumBlock(const Atlas::SnapshotBlock& block)
+	{
+		const std::uint32_t value = checksum(block.owners, block.count * sizeof(std::uint32_t));
+		return checksum(block.data, block.size, value);
+	}
+
+	/** Checksum of the Entity table and the groups, in any order of groups */
+	std::uint32_t checksumState(const Atlas::SnapshotContents& contents)
+	{
+		std::uint32_t value = checksum(contents.entities, contents.entityCount * sizeof(std::uint32_t));
+
+		for (const auto& group : contents.groups)
+		{
+			const std::uint32_t name = checksum(group.name.data(), group.name.size());
+			value += checksum(group.members, group.count * sizeof(std::uint32_t), name);
+		}
+
+		return value;
+	}
+
+	/**
+	* Writes the changes between two blocks of the same Component type.
+	* Either block may be missing, in which case every entry of the other one changed.
+	* @return True if anything changed and the block was written
+	*/
+	bool writeBlock(const Atlas::SnapshotBlock* from, const Atlas::SnapshotBlock* to,
+		const std::vector<bool>& isDestroyed, Atlas::SnapshotWriter& writer)
+	{
+		const Atlas::SnapshotBlock& any = (to != nullptr) ? *to : *from;
+		const std::size_t dataSize = any.dataSize;
+
+		std::vector<const char*> fromEntries, toEntries;
+		std::vector<std::uint32_t> fromSizes, toSizes;
+		std::size_t fromCount = 0, toCount = 0;
+
+		if (from != nullptr)
+		{
+			findEntries(*from, fromEntries, fromSizes);
+			fromCount = from->count;
+		}
+
+		if (to != nullptr)
+		{
+			findEntries(*to, toEntries, toSizes);
+			toCount = to->count;
+		}
+
+		// both owner lists are sorted, so they are merged in a single pass
+		std::vector<std::uint32_t> removed, added, changed;
+		std::vector<std::size_t> addedEntries, changedFrom, changedTo;
+		std::size_t i = 0, j = 0;
+
+		while (i < fromCount || j < toCount)
+		{
+			if (j == toCount || (i < fromCount && from->owners[i] < to->owners[j]))
+			{
+				// Components of destroyed Entities go with them
+				if (!isDestroyed[from->owners[i]])
+					removed.push_back(from->owners[i]);
+				i++;
+			}
+			else if (i == fromCount || to->owners[j] < from->owners[i])
+			{
+				added.push_back(to->owners[j]);
+				addedEntries.push_back(j);
+				j++;
+			}
+			else
+			{
+				if (fromSizes[i] != toSizes[j] || std::memcmp(fromEntries[i], toEntries[j], toSizes[j]) != 0)
+				{
+					changed.push_back(to->owners[j]);
+					changedFrom.push_back(i);
+					changedTo.push_back(j);
+				}
+				i++;
+				j++;
+			}
+		}
+
+		if (removed.empty() && added.empty() && changed.empty())
+			return false;
+
+		writer.writeString(any.name);
+		writer.writeUInt((std::uint32_t)dataSize);
+		writer.writeArray(removed.data(), removed.size());
+
+		writer.writeArray(added.data(), added.size());
+		writer.align(Atlas::Snapshot::ALIGNMENT);
+
+		for (const auto& entry : addedEntries)
+		{
+			if (dataSize == 0)
+				writer.writeUInt(toSizes[entry]);
+
+			writer.write(toEntries[entry], toSizes[entry]);
+		}
+
+		writer.writeArray(changed.data(), changed.size());
+
+		if (dataSize > 0)
+		{
+			const std::size_t offset = writer.reserve(sizeof(std::uint32_t));
+
+			for (std::size_t k = 0; k < changed.size(); k++)
+				writeXorRuns(fromEntries[changedFrom[k]], toEntries[changedTo[k]], dataSize, writer);
+
+			std::vector<char>& buffer = writer.getBuffer();
+			const std::uint32_t size = (std::uint32_t)(buffer.size() - offset - sizeof(std::uint32_t));
+			std::memcpy(&buffer[offset], &size, sizeof(size));
+		}
+		else
+		{
+			// hook entries can not be patched without the old data, so they are replaced
+			for (const auto& entry : changedTo)
+			{
+				writer.writeUInt(toSizes[entry]);
+				writer.write(toEntries[entry], toSizes[entry]);
+			}
+		}
+
+		return true;
+	}
+}
+
+namespace Atlas
+{
+	std::vector<char> SnapshotDelta::create(const std::vector<char>& from, const std::vector<char>& to)
+	{
+		return create(from.data(), from.size(), to.data(), to.size());
+	}
+
+	std::vector<char> SnapshotDelta::create(const char* fromData, std::size_t fromSize, const char* toData, std::size_t toSize)
+	{
+		SnapshotContents from, to;
+		if (!Snapshot::parse(fromData, fromSize, from) || !Snapshot::parse(toData, toSize, to))
+			return std::vector<char>();
+
+		std::vector<char> buffer;
+		SnapshotWriter writer(buffer);
+
+		writer.write(MAGIC, sizeof(MAGIC));
+		writer.writeUInt(VERSION);
+
+		// the state the delta applies to
+		writer.writeUInt(from.nextID);
+		writer.writeUInt((std::uint32_t)from.entityCount);
+		writer.writeUInt(checksumState(from));
+		writer.writeUInt(to.nextID);
+
+		// Entities
+		std::vector<std::uint32_t> destroyed, created;
+		std::set_difference(from.entities, from.entities + from.entityCount,
+			to.entities, to.entities + to.entityCount, std::back_inserter(destroyed));
+		std::set_difference(to.entities, to.entities + to.entityCount,
+			from.entities, from.entities + from.entityCount, std::back_inserter(created));
+
+		writer.writeArray(destroyed.data(), destroyed.size());
+		writer.writeArray(created.data(), created.size());
+
+		// checksums of every Component type the older snapshot holds, unchanged types included
+		std::uint32_t baseBlockCount = 0;
+		for (const auto& fromBlock : from.blocks)
+			if (fromBlock.count > 0)
+				baseBlockCount++;
+
+		writer.writeUInt(baseBlockCount);
+
+		for (const auto& fromBlock : from.blocks)
+		{
+			if (fromBlock.count == 0)
+				continue;
+
+			writer.writeString(fromBlock.name);
+			writer.writeUInt((std::uint32_t)fromBlock.dataSize);
+			writer.writeUInt(checksumBlock(fromBlock));
+		}
+
+		std::vector<bool> isDestroyed(from.nextID, false);
+		for (const auto& id : destroyed)
+			isDestroyed[id] = true;
+
+		// Component blocks, including types that only one of the snapshots has
+		const std::size_t blockOffset = writer.reserve(sizeof(std::uint32_t));
+		std::uint32_t blockCount = 0;
+
+		for (const auto& toBlock : to.blocks)
+			if (writeBlock(findBlock(from, toBlock.name, toBlock.dataSize), &toBlock, isDestroyed, writer))
+				blockCount++;
+
+		for (const auto& fromBlock : from.blocks)
+			if (findBlock(to, fromBlock.name, fromBlock.dataSize) == nullptr && writeBlock(&fromBlock, nullptr, isDestroyed, writer))
+				blockCount++;
+
+		std::memcpy(&buffer[blockOffset], &blockCount, sizeof(blockCount));
+
+		// groups that changed are replaced, groups that are gone are written empty
+		const std::size_t groupOffset = writer.reserve(sizeof(std::uint32_t));
+		std::uint32_t groupCount = 0;
+
+		for (const auto& toGroup : to.groups)
+		{
+			const SnapshotGroup* fromGroup = findGroup(from, toGroup.name);
+			if (fromGroup != nullptr && fromGroup->count == toGroup.count
+				&& std::equal(toGroup.members, toGroup.members + toGroup.count, fromGroup->members))
+				continue;
+
+			writer.writeString(toGroup.name);
+			writer.writeArray(toGroup.members, toGroup.count);
+			groupCount++;
+		}
+
+		for (const auto& fromGroup : from.groups)
+		{
+			if (findGroup(to, fromGroup.name) != nullptr)
+				continue;
+
+			writer.writeString(fromGroup.name);
+			writer.writeArray(nullptr, 0);
+			groupCount++;
+		}
+
+		std::memcpy(&buffer[groupOffset], &groupCount, sizeof(groupCount));
+
+		return buffer;
+	}
+
+	bool SnapshotDelta::parse(const char* data, std::size_t size, Contents& contents)
+	{
+		SnapshotReader reader(data, size);
+
+		char magic[sizeof(MAGIC)];
+		if (!reader.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+			return false;
+
+		if (reader.readUInt() != VERSION)
+			return false;
+
+		contents.baseNextID = reader.readUInt();
+		contents.baseCount = reader.readUInt();
+		contents.baseChecksum = reader.readUInt();
+		contents.nextID = reader.readUInt();
+
+		// Entities
+		contents.destroyed = reader.readArray(contents.baseNextID, contents.destroyedCount);
+		contents.created = reader.readArray(contents.nextID, contents.createdCount);
+
+		if (contents.destroyed == nullptr || contents.created == nullptr)
+			return false;
+
+		// checksums of the older state
+		contents.baseBlocks.clear();
+		const std::uint32_t baseBlockCount = reader.readUInt();
+
+		for (std::uint32_t i = 0; i < baseBlockCount && reader.isValid(); i++)
+		{
+			BaseBlock block;
+			block.name = reader.readString();
+			block.dataSize = reader.readUInt();
+			block.checksum = reader.readUInt();
+
+			contents.baseBlocks.push_back(block);
+		}
+
+		// Component blocks
+		contents.blocks.clear();
+		const std::uint32_t blockCount = reader.readUInt();
+
+		for (std::uint32_t i = 0; i < blockCount && reader.isValid(); i++)
+		{
+			Block block;
+			block.name = reader.readString();
+			block.dataSize = reader.readUInt();
+
+			block.removed = reader.readArray(contents.baseNextID, block.removedCount);
+			block.added = reader.readArray(contents.nextID, block.addedCount);
+
+			if (block.removed == nullptr || block.added == nullptr)
+				return false;
+
+			reader.align(Snapshot::ALIGNMENT);
+			block.addedData = skipEntries(reader, block.dataSize, block.addedCount, block.addedSize);
+
+			// changed Entities exist in both states
+			block.changed = reader.readArray(std::min(contents.baseNextID, contents.nextID), block.changedCount);
+
+			if (block.addedData == nullptr || block.changed == nullptr)
+				return false;
+
+			if (block.dataSize > 0)
+			{
+				block.changedSize = reader.readUInt();
+				block.changedData = reader.skip(block.changedSize);
+
+				if (block.changedData == nullptr)
+					return false;
+
+				const char* runs = block.changedData;
+				const char* end = block.changedData + block.changedSize;
+
+				for (std::size_t j = 0; j < block.changedCount && runs != nullptr; j++)
+					runs = skipXorRuns(runs, end, block.dataSize);
+
+				if (runs != end)
+					return false;
+			}
+			else
+			{
+				block.changedData = skipEntries(reader, 0, block.changedCount, block.changedSize);
+
+				if (block.changedData == nullptr)
+					return false;
+			}
+
+			contents.blocks.push_back(block);
+		}
+
+		// groups
+		contents.groups.clear();
+		const std::uint32_t groupCount = reader.readUInt();
+
+		for (std::uint32_t i = 0; i < groupCount && reader.isValid(); i++)
+		{
+			SnapshotGroup group;
+			group.name = reader.readString();
+			group.members = reader.readArray(contents.nextID, group.count);
+
+			if (group.members == nullptr)
+				return false;
+
+			contents.groups.push_back(group);
+		}
+
+		return reader.isValid();
+	}
+
+	bool SnapshotDelta::check(World& world, const Contents& contents, std::vector<unsigned int>& types)
+	{
+		const EntityManager& eManager = world.getEntityManager();
+		const auto& entities = eManager.mActiveEntities;
+
+		if (contents.baseNextID != eManager.mNextAvaibleID || contents.baseCount != eManager.mActiveEntityCount)
+			return false;
+
+		// the World is saved and compared to the checksums of the older snapshot
+		const std::vector<char> current = Snapshot::save(world);
+		SnapshotContents state;
+
+		if (!Snapshot::parse(current.data(), current.size(), state) || checksumState(state) != contents.baseChecksum)
+			return false;
+
+		for (const auto& block : state.blocks)
+		{
+			auto base = std::find_if(contents.baseBlocks.begin(), contents.baseBlocks.end(),
+				[&block](const BaseBlock& baseBlock) { return baseBlock.name == block.name; });
+
+			// types registered differently are skipped when the delta is applied
+			if (base != contents.baseBlocks.end() && base->dataSize != block.dataSize)
+				continue;
+
+			// a type the older snapshot did not hold must be empty
+			const std::uint32_t expected = (base != contents.baseBlocks.end()) ? base->checksum : checksum(nullptr, 0);
+			if (checksumBlock(block) != expected)
+				return false;
+		}
+
+		// Entities alive once the delta is applied
+		std::vector<bool> isAlive(std::max(contents.baseNextID, contents.nextID), false);
+
+		for (Entity::ID id = 0; id < contents.baseNextID && id < entities.size(); id++)
+			isAlive[id] = entities[id] != nullptr && entities[id]->isActive();
+
+		for (std::size_t i = 0; i < contents.destroyedCount; i++)
+		{
+			const auto& id = contents.destroyed[i];
+			if (!isAlive[id])
+				return false;
+
+			isAlive[id] = false;
+		}
+
+		std::vector<bool> isCreated(contents.nextID, false);
+
+		for (std::size_t i = 0; i < contents.createdCount; i++)
+		{
+			const auto& id = contents.created[i];
+			if (id < entities.size() && entities[id] != nullptr)
+				return false;
+
+			isAlive[id] = true;
+			isCreated[id] = true;
+		}
+
+		for (Entity::ID id = contents.nextID; id < isAlive.size(); id++)
+			if (isAlive[id])
+				return false;
+
+		// Component types that are not registered, or were registered differently, are skipped
+		types.clear();
+
+		for (const auto& block : contents.blocks)
+		{
+			const unsigned int type = Snapshot::findType(block.name);
+			if (type >= BITSIZE || block.dataSize != Snapshot::mSerializers[type].dataSize)
+			{
+				types.push_back(BITSIZE);
+				continue;
+			}
+
+			const auto& typeComponents = eManager.readTable(type);
+			auto hasComponent = [&](std::uint32_t id)
+			{
+				return isAlive[id] && !isCreated[id] && id < typeComponents.size() && typeComponents[id] != nullptr;
+			};
+
+			for (std::size_t i = 0; i < block.removedCount; i++)
+				if (!hasComponent(block.removed[i]))
+					return false;
+
+			for (std::size_t i = 0; i < block.changedCount; i++)
+				if (!hasComponent(block.changed[i]))
+					return false;
+
+			for (std::size_t i = 0; i < block.addedCount; i++)
+				if (!isAlive[block.added[i]] || hasComponent(block.added[i]))
+					return false;
+
+			types.push_back(type);
+		}
+
+		for (const auto& group : contents.groups)
+			for (std::size_t i = 0; i < group.count; i++)
+				if (!isAlive[group.members[i]])
+					return false;
+
+		return true;
+	}
+
+	bool SnapshotDelta::apply(World& world, const char* data, std::size_t size)
+	{
+		// read and check everything before the World is touched
+		Contents contents;
+		std::vector<unsigned int> types;
+
+		if (!parse(data, size, contents) || !check(world, contents, types))
+			return false;
+
+		EntityManager& eManager = world.getEntityManager();
+		GroupManager& gManager = world.getGroupManager();
+		SystemManager& sManager = world.getSystemManager();
+		FieldManager& fManager = world.getFieldManager();
+
+		// Entities
+		for (std::size_t i = 0; i < contents.destroyedCount; i++)
+		{
+			Entity& entity = eManager.getEntity(contents.destroyed[i]);
+			entity.setActive(false);
+			eManager.removeEntity(entity);
+		}
+
+		eManager.restoreEntities(contents.created, contents.createdCount, contents.nextID);
+
+		// Entities whose signature changed are checked against the Systems once at the end
+		std::vector<bool> isTouched(contents.nextID, false);
+		for (std::size_t i = 0; i < contents.createdCount; i++)
+			isTouched[contents.created[i]] = true;
+
+		// Components
+		for (std::size_t b = 0; b < contents.blocks.size(); b++)
+		{
+			if (types[b] >= BITSIZE)
+				continue;
+
+			const Block& block = contents.blocks[b];
+			const Snapshot::Serializer& serializer = Snapshot::mSerializers[types[b]];
+			const ComponentIdentifier& identifier = *serializer.identifier;
+
+			for (std::size_t i = 0; i < block.removedCount; i++)
+			{
+				eManager.detachComponent(eManager.getEntity(block.removed[i]), identifier);
+				isTouched[block.removed[i]] = true;
+			}
+
+			if (block.addedCount > 0)
+				eManager.reserveComponents(identifier, block.added[block.addedCount - 1] + 1);
+
+			SnapshotReader addedEntries(block.addedData, block.addedSize);
+			const char* source = block.addedData;
+
+			for (std::size_t i = 0; i < block.addedCount; i++)
+			{
+				Component::Ptr component = Snapshot::readComponent(serializer, fManager, block.added[i], source, addedEntries);
+
+				if (component != nullptr)
+				{
+					eManager.attachComponent(eManager.getEntity(block.added[i]), identifier, std::move(component));
+					isTouched[block.added[i]] = true;
+				}
+			}
+
+			auto& typeComponents = eManager.getTable(types[b]);
+
+			if (serializer.loadFields != nullptr)
+			{
+				// fields live in the FieldManager, each row is patched through a copy
+				std::vector<char> row(block.dataSize);
+				const char* runs = block.changedData;
+
+				for (std::size_t i = 0; i < block.changedCount; i++)
+				{
+					serializer.saveFields(fManager, block.changed[i], row.data());
+					runs = applyXorRuns(row.data(), runs, block.dataSize);
+					serializer.loadFields(fManager, block.changed[i], row.data());
+				}
+			}
+			else if (block.dataSize > 0)
+			{
+				// patch the changed bytes in place
+				const char* runs = block.changedData;
+
+				for (std::size_t i = 0; i < block.changedCount; i++)
+				{
+					char* target = reinterpret_cast<char*>(typeComponents[block.changed[i]].get()) + sizeof(Component);
+					runs = applyXorRuns(target, runs, block.dataSize);
+				}
+			}
+			else
+			{
+				SnapshotReader changedEntries(block.changedData, block.changedSize);
+				source = block.changedData;
+
+				for (std::size_t i = 0; i < block.changedCount; i++)
+				{
+					Component::Ptr component = Snapshot::readComponent(serializer, fManager, block.changed[i], source, changedEntries);
+
+					if (component != nullptr)
+						typeComponents[block.changed[i]] = std::move(component);
+				}
+			}
+		}
+
+		// groups are replaced
+		for (const auto& group : contents.groups)
+		{
+			for (const auto& id : gManager.getGroup(group.name))
+				gManager.removeFromGroup(group.name, eManager.getEntity(id));
+
+			for (std::size_t i = 0; i < group.count; i++)
+				gManager.addToGroup(group.name, eManager.getEntity(group.members[i]));
+		}
+
+		// ids above the new range were all destroyed
+		if (contents.nextID < eManager.mNextAvaibleID)
+			eManager.releaseDeadEntitiesFrom(contents.nextID);
+
+		for (Entity::ID id = 0; id < isTouched.size(); id++)
+			if (isTouched[id])
+				sManager.checkInterest(eManager.getEntity(id));
+
+		return true;
+	}
+}
@@ -0,0 +1,322 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Atlas
+{
+	namespace
+	{
+		/** Cell coordinates are clamped so far away positions can not overflow them */
+		const float CELL_LIMIT = 1073741824.0f;
+	}
+
+	std::size_t SpatialResults::size() const
+	{
+		return offsets.empty() ? 0 : offsets.size() - 1;
+	}
+
+	std::size_t SpatialResults::count(std::size_t query) const
+	{
+		assert(query < size());
+		return offsets[query + 1] - offsets[query];
+	}
+
+	const Entity::ID* SpatialResults::get(std::size_t query) const
+	{
+		assert(query < size());
+		return entities.data() + offsets[query];
+	}
+
+	SpatialGrid::SpatialGrid(World& world, float cellSize)
+		: System(world)
+		, mCellSize(cellSize)
+		, mInverseCellSize(1.0f / cellSize)
+		, mCells()
+		, mSlots()
+		, mMoved()
+		, mIsPolling(true)
+	{
+		assert(cellSize > 0.0f);
+	}
+
+	void SpatialGrid::update(float)
+	{
+		if (mIsPolling)
+		{
+			for (const auto& id : getEntities())
+				place(id, getPosition(id));
+		}
+		else
+		{
+			// Entities removed or relocated since they were reported are no longer marked
+			for (const auto& id : mMoved)
+				if (id < mSlots.size() && mSlots[id].isMoved)
+					place(id, getPosition(id));
+		}
+
+		mMoved.clear();
+	}
+
+	void SpatialGrid::moved(Entity::ID id)
+	{
+		// Entities outside the grid are placed when they are added
+		if (mIsPolling || id >= mSlots.size() || !mSlots[id].isIndexed || mSlots[id].isMoved)
+			return;
+
+		mSlots[id].isMoved = true;
+		mMoved.push_back(id);
+	}
+
+	void SpatialGrid::setPolling(bool isPolling)
+	{
+		mIsPolling = isPolling;
+	}
+
+	void SpatialGrid::queryRadius(const Point& center, float radius, std::vector<Entity::ID>& results) const
+	{
+		const Bounds bounds = { { center.x - radius, center.y - radius }, { center.x + radius, center.y + radius } };
+		const float radiusSquared = radius * radius;
+
+		forEachEntry(bounds, [&](const Entry& entry)
+		{
+			const float dx = entry.position.x - center.x;
+			const float dy = entry.position.y - center.y;
+
+			if (dx * dx + dy * dy <= radiusSquared)
+				results.push_back(entry.id);
+		});
+	}
+
+	void SpatialGrid::queryRadius(const std::vector<Circle>& circles, SpatialResults& results) const
+	{
+		results.entities.clear();
+		results.offsets.clear();
+		results.offsets.reserve(circles.size() + 1);
+
+		for (const auto& circle : circles)
+		{
+			results.offsets.push_back(results.entities.size());
+			queryRadius(circle.center, circle.radius, results.entities);
+		}
+
+		results.offsets.push_back(results.entities.size());
+	}
+
+	void SpatialGrid::queryBounds(const Bounds& bounds, std::vector<Entity::ID>& results) const
+	{
+		forEachEntry(bounds, [&](const Entry& entry)
+		{
+			if (entry.position.x >= bounds.min.x && entry.position.x <= bounds.max.x
+				&& entry.position.y >= bounds.min.y && entry.position.y <= bounds.max.y)
+				results.push_back(entry.id);
+		});
+	}
+
+	void SpatialGrid::queryBounds(const std::vector<Bounds>& bounds, SpatialResults& results) const
+	{
+		results.entities.clear();
+		results.offsets.clear();
+		results.offsets.reserve(bounds.size() + 1);
+
+		for (const auto& box : bounds)
+		{
+			results.offsets.push_back(results.entities.size());
+			queryBounds(box, results.entities);
+		}
+
+		results.offsets.push_back(results.entities.size());
+	}
+
+	bool SpatialGrid::findNearest(const Point& point, float maxRadius, Entity::ID& nearest) const
+	{
+		// search boxes of growing size; the closest Entry within the radius of a box
+		// is the closest overall, since anything outside the box is further away
+		float radius = std::min(mCellSize, maxRadius);
+
+		while (radius >= 0.0f)
+		{
+			const Bounds bounds = { { point.x - radius, point.y - radius }, { point.x + radius, point.y + radius } };
+			float bestSquared = radius * radius;
+			bool isFound = false;
+
+			forEachEntry(bounds, [&](const Entry& entry)
+			{
+				const float dx = entry.position.x - point.x;
+				const float dy = entry.position.y - point.y;
+				const float distanceSquared = dx * dx + dy * dy;
+
+				if (distanceSquared < bestSquared || (!isFound && distanceSquared == bestSquared))
+				{
+					bestSquared = distanceSquared;
+					nearest = entry.id;
+					isFound = true;
+				}
+			});
+
+			if (isFound)
+				return true;
+
+			if (radius >= maxRadius)
+				break;
+
+			radius = std::min(radius * 2.0f, maxRadius);
+		}
+
+		return false;
+	}
+
+	float SpatialGrid::getCellSize() const
+	{
+		return mCellSize;
+	}
+
+	void SpatialGrid::entityAdded(Entity& entity)
+	{
+		place(entity.getID(), getPosition(entity.getID()));
+	}
+
+	void SpatialGrid::entityRemoved(Entity& entity)
+	{
+		erase(entity.getID());
+	}
+
+	void SpatialGrid::entitiesRemapped(const std::vector<Entity::Relocation>& relocations)
+	{
+		for (const auto& relocation : relocations)
+		{
+			const auto& from = relocation.first;
+			const auto& to = relocation.second;
+
+			if (from >= mSlots.size() || !mSlots[from].isIndexed)
+				continue;
+
+			// relocations always move down, so the new id fits the table
+			const Slot slot = mSlots[from];
+			mCells[slot.cell][slot.index].id = to;
+			mSlots[to] = slot;
+			mSlots[from].isIndexed = false;
+			mSlots[from].isMoved = false;
+
+			if (slot.isMoved)
+				mMoved.push_back(to);
+		}
+	}
+
+	void SpatialGrid::entitiesReplaced()
+	{
+		mCells.clear();
+		mSlots.clear();
+		mMoved.clear();
+
+		for (const auto& id : getEntities())
+			place(id, getPosition(id));
+	}
+
+	void SpatialGrid::place(Entity::ID id, const Point& position)
+	{
+		const std::uint64_t key = toKey(toCell(position.x), toCell(position.y));
+
+		if (mSlots.size() <= id)
+		{
+			const Slot empty = { 0, 0, false, false };
+			mSlots.resize(id * 2 + 1, empty);
+		}
+
+		Slot& slot = mSlots[id];
+		slot.isMoved = false;
+
+		// still in the same cell, only the stored position changes
+		if (slot.isIndexed && slot.cell == key)
+		{
+			mCells[key][slot.index].position = position;
+			return;
+		}
+
+		erase(id);
+
+		Cell& cell = mCells[key];
+		const Entry entry = { id, position };
+
+		slot.cell = key;
+		slot.index = static_cast<std::uint32_t>(cell.size());
+		slot.isIndexed = true;
+		cell.push_back(entry);
+	}
+
+	void SpatialGrid::erase(Entity::ID id)
+	{
+		if (id >= mSlots.size() || !mSlots[id].isIndexed)
+			return;
+
+		Slot& slot = mSlots[id];
+		auto itr = mCells.find(slot.cell);
+		Cell& cell = itr->second;
+
+		// fill the gap with the last Entry of the cell
+		cell[slot.index] = cell.back();
+		mSlots[cell[slot.index].id].index = slot.index;
+		cell.pop_back();
+
+		if (cell.empty())
+			mCells.erase(itr);
+
+		slot.isIndexed = false;
+		slot.isMoved = false;
+	}
+
+	template <typename Visit>
+	void SpatialGrid::forEachEntry(const Bounds& bounds, Visit visit) const
+	{
+		const std::int32_t minX = toCell(bounds.min.x);
+		const std::int32_t minY = toCell(bounds.min.y);
+		const std::int32_t maxX = toCell(bounds.max.x);
+		const std::int32_t maxY = toCell(bounds.max.y);
+
+		if (minX > maxX || minY > maxY)
+			return;
+
+		const std::uint64_t area = std::uint64_t(std::int64_t(maxX) - minX + 1) * std::uint64_t(std::int64_t(maxY) - minY + 1);
+
+		// large boxes walk the occupied cells instead of every cell they cover
+		if (area > mCells.size())
+		{
+			for (const auto& cell : mCells)
+			{
+				const std::int32_t x = static_cast<std::int32_t>(cell.first >> 32);
+				const std::int32_t y = static_cast<std::int32_t>(cell.first & 0xFFFFFFFF);
+
+				if (x >= minX && x <= maxX && y >= minY && y <= maxY)
+					for (const auto& entry : cell.second)
+						visit(entry);
+			}
+
+			return;
+		}
+
+		for (std::int32_t y = minY; y <= maxY; y++)
+		{
+			for (std::int32_t x = minX; x <= maxX; x++)
+			{
+				auto cell = mCells.find(toKey(x, y));
+				if (cell == mCells.end())
+					continue;
+
+				for (const auto& entry : cell->second)
+					visit(entry);
+			}
+		}
+	}
+
+	std::int32_t SpatialGrid::toCell(float value) const
+	{
+		const float cell = std::max(-CELL_LIMIT, std::min(std::floor(value * mInverseCellSize), CELL_LIMIT));
+		return static_cast<std::int32_t>(cell);
+	}
+
+	std::uint64_t SpatialGrid::toKey(std::int32_t x, std::int32_t y)
+	{
+		return (std::uint64_t(std::uint32_t(x)) << 32) | std::uint32_t(y);
+	}
+}
@@ -0,0 +1,62 @@
+#include "SpawnBuffer.h"
+#include "ComponentIdentifierManager.h"
+#include "EntityManager.h"
+
+#include <cassert>
+
+namespace Atlas
+{
+	SpawnBuffer::Shard::Shard()
+		: identifier(nullptr)
+		, owners()
+		, components()
+	{
+	}
+
+	SpawnBuffer::SpawnBuffer(EntityManager& eManager, unsigned int blockSize)
+		: mEntityManager(eManager)
+		, mBlockSize(blockSize)
+		, mNextID(0)
+		, mBlockEnd(0)
+		, mReserved(0)
+		, mEntities()
+		, mShards(BITSIZE)
+	{
+		assert(blockSize > 0);
+	}
+
+	SpawnBuffer::~SpawnBuffer()
+	{
+		// uncommitted ids would be missing from the World for good
+		assert(mReserved == 0 && "SpawnBuffer destroyed without being committed");
+	}
+
+	Entity::ID SpawnBuffer::createEntity()
+	{
+		if (mNextID == mBlockEnd)
+		{
+			mNextID = mEntityManager.reserveIDs(mBlockSize);
+			mBlockEnd = mNextID + mBlockSize;
+			mReserved += mBlockSize;
+		}
+
+		mEntities.push_back(mNextID);
+		return mNextID++;
+	}
+
+	void SpawnBuffer::addComponent(Entity::ID id, Component::Ptr component)
+	{
+		// registry lookups do not lock, so the type is resolved on the worker thread
+		const ComponentIdentifier& identifier = ComponentIdentifierManager::getType(typeid(*component));
+
+		Shard& shard = mShards[identifier.getID()];
+		shard.identifier = &identifier;
+		shard.owners.push_back(id);
+		shard.components.push_back(std::move(component));
+	}
+
+	std::size_t SpawnBuffer::size() const
+	{
+		return mEntities.size();
+	}
+}
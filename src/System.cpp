@@ -1,14 +1,31 @@
 #include "System.h"
 #include "Utilities.h"
+#include "World.h"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
 #include <iostream>
+#include <unordered_map>
 
 namespace Atlas
 {
+	namespace
+	{
+		/** Entity list of Systems that are not in a World or process no Component types */
+		const std::vector<Entity::ID> NO_ENTITIES;
+	}
+
 	System::System(World& world)
 		: mWorld(world)
-		, mTypeBits()
+		, mSignature()
 		, mSystemBits()
-		, mEntities()
+		, mResourceReads()
+		, mResourceWrites()
+		, mQuery(nullptr)
+		, mIsDepthFirst(false)
+		, mSchedule()
+		, mStats()
 	{
 		////////////////////////////////////////////////////////////////////////////
 		////// Call addComponentType() in derived classes //////////////////////////
@@ -17,28 +34,129 @@ namespace Atlas
 
 	void System::checkInterest(Entity& e)
 	{
-		// check if entity is already in our system and if this system is
-		// interested in processing it
-		bool contains = (e.getSystemBits() & mSystemBits) == mSystemBits;
-		bool interest = (e.getComponentBits() & mTypeBits) == mTypeBits;
+		if (mQuery != nullptr)
+			mQuery->checkInterest(e);
+	}
 
-		// It is not in the system, but we are interested
-		if (!contains && interest && mTypeBits.any())
-		{
-			mEntities.push_back(e.getID());
-			e.setSystemBit(mSystemBits);
-		}
-		// It is in the system, but we are not interested
-		else if (contains && !interest && mTypeBits.any())
+	void System::entityAdded(Entity&)
+	{
+	}
+
+	void System::entityRemoved(Entity&)
+	{
+	}
+
+	void System::entitiesRemapped(const std::vector<Entity::Relocation>&)
+	{
+	}
+
+	void System::entitiesReplaced()
+	{
+	}
+
+	void System::taskStarting()
+	{
+	}
+
+	void System::taskCompleted()
+	{
+	}
+
+	void System::setUpdateRate(float frequency, unsigned int slices)
+	{
+		assert(frequency > 0.0f && slices > 0);
+
+		mSchedule.mode = Schedule::RATE;
+		mSchedule.interval = 1.0f / frequency;
+		mSchedule.slices = slices;
+		mSchedule.slice = 0;
+		mSchedule.accumulator = 0.0f;
+		mSchedule.sliceElapsed.assign(slices, 0.0f);
+	}
+
+	void System::setFixedTimestep(float step, unsigned int maxSteps)
+	{
+		assert(step > 0.0f && maxSteps > 0);
+		assert(!mSchedule.isAsync && "Asynchronous Systems can not use fixed timesteps");
+
+		mSchedule.mode = Schedule::FIXED_STEP;
+		mSchedule.interval = step;
+		mSchedule.maxSteps = maxSteps;
+		mSchedule.slices = 1;
+		mSchedule.slice = 0;
+		mSchedule.accumulator = 0.0f;
+	}
+
+	void System::setBudget(double microseconds)
+	{
+		mSchedule.budget = microseconds;
+	}
+
+	void System::setTimeSliced(double microseconds)
+	{
+		assert(microseconds > 0.0);
+		assert(!mSchedule.isAsync && "Asynchronous Systems can not be time sliced");
+
+		mSchedule.isTimeSliced = true;
+		mSchedule.timeSlice = microseconds;
+		mSchedule.pass.clear();
+		mSchedule.cursor = 0;
+	}
+
+	void System::setAsync(bool enabled)
+	{
+		assert((!enabled || (mSchedule.mode != Schedule::FIXED_STEP && !mSchedule.isTimeSliced))
+			&& "Asynchronous Systems can not use fixed timesteps or time slicing");
+
+		wait();
+		mSchedule.isAsync = enabled;
+		mSchedule.waited = 0.0f;
+	}
+
+	bool System::nextEntity(Entity::ID& id)
+	{
+		assert(mSchedule.isTimeSliced && "Call setTimeSliced() first");
+
+		while (mSchedule.cursor < mSchedule.pass.size())
 		{
-			remove(e);
+			// stop when the next Entity is expected to run past the deadline,
+			// judged by the average time of the Entities processed so far
+			if (mSchedule.processed > 0)
+			{
+				const Schedule::Clock::time_point now = Schedule::Clock::now();
+				const auto average = (now - mSchedule.start) / static_cast<long long>(mSchedule.processed);
+
+				if (now + average > mSchedule.deadline)
+					return false;
+			}
+
+			id = mSchedule.pass[mSchedule.cursor++];
+
+			// skip Entities that left the System since the pass started
+			if (mQuery != nullptr && mQuery->contains(id))
+			{
+				mSchedule.processed++;
+				return true;
+			}
 		}
+
+		return false;
 	}
 
-	void System::remove(Entity& e)
+	EntityRange System::getEntityRange() const
 	{
-		e.removeSystemBit(mSystemBits);
-		mEntities.erase(std::find(mEntities.begin(), mEntities.end(), e.getID()));
+		const std::vector<Entity::ID>& entities = mSchedule.isAsync ? mSchedule.pass : getEntities();
+		const std::size_t size = entities.size();
+
+		const std::size_t first = size * mSchedule.slice / mSchedule.slices;
+		const std::size_t last = size * (mSchedule.slice + 1) / mSchedule.slices;
+
+		return EntityRange(entities.data() + first, entities.data() + last);
+	}
+
+	void System::setDepthFirst(bool enabled)
+	{
+		mIsDepthFirst = enabled;
 	}
 
 	void System::setSystemBits(const std::bitset<BITSIZE>& bit)
@@ -51,14 +169,103 @@ namespace Atlas
 		return mSystemBits;
 	}
 
+	const ScheduleStats& System::getStats() const
+	{
+		return mStats;
+	}
+
+	bool System::isRunning() const
+	{
+		return mSchedule.task.valid();
+	}
+
+	void System::wait()
+	{
+		if (mSchedule.task.valid())
+			finishTask();
+	}
+
 	std::bitset<BITSIZE> System::getTypeBits() const
 	{
-		return mTypeBits;
+		return mSignature.required;
+	}
+
+	const Signature& System::getSignature() const
+	{
+		return mSignature;
+	}
+
+	void System::beginPass()
+	{
+		mSchedule.processed = 0;
+
+		if (mSchedule.cursor < mSchedule.pass.size())
+			return;
+
+		mSchedule.pass = getEntities();
+		mSchedule.cursor = 0;
+	}
+
+	void System::startTask(float dt)
+	{
+		assert(!mSchedule.task.valid());
+
+		mSchedule.pass = getEntities();
+		mSchedule.start = Schedule::Clock::now();
+		taskStarting();
+
+		System* system = this;
+		mSchedule.task = std::async(std::launch::async, [system, dt]() { system->update(dt); });
+	}
+
+	void System::finishTask()
+	{
+		// get() waits for the task and rethrows an exception from update()
+		mSchedule.task.get();
+
+		recordRun(std::chrono::duration<double, std::micro>(Schedule::Clock::now() - mSchedule.start).count());
+		taskCompleted();
+	}
+
+	bool System::conflictsWith(const System& other) const
+	{
+		return (mResourceWrites & (other.mResourceReads | other.mResourceWrites)).any()
+			|| (other.mResourceWrites & mResourceReads).any();
+	}
+
+	void System::recordRun(double microseconds)
+	{
+		mStats.runs++;
+		mStats.lastMicroseconds = microseconds;
+		mStats.maxMicroseconds = std::max(mStats.maxMicroseconds, microseconds);
+
+		if (mSchedule.budget > 0.0 && microseconds > mSchedule.budget)
+			mStats.overruns++;
+	}
+
+	void System::remapPass(const std::vector<Entity::Relocation>& relocations)
+	{
+		if (mSchedule.cursor >= mSchedule.pass.size())
+			return;
+
+		std::unordered_map<Entity::ID, Entity::ID> newIDs(relocations.begin(), relocations.end());
+
+		for (auto id = mSchedule.pass.begin() + mSchedule.cursor; id != mSchedule.pass.end(); ++id)
+		{
+			auto itr = newIDs.find(*id);
+			if (itr != newIDs.end())
+				*id = itr->second;
+		}
+	}
+
+	bool System::ownsComponent(Entity::ID id, unsigned int type) const
+	{
+		return mWorld.getEntity(id).getComponentBits().test(type);
 	}
 
 	const std::vector<Entity::ID>& System::getEntities() const
 	{
-		return mEntities;
+		return mQuery != nullptr ? mQuery->getEntities() : NO_ENTITIES;
 	}
 
 	World& System::getWorld() const
@@ -76,11 +283,16 @@ namespace Atlas
 			<< endl;
 
 		cout << "Interested Entities: ";
-		for (const auto& e : mEntities)
+		for (const auto& e : getEntities())
 			cout << e << ", ";
 
 		cout << "\nSystemBits: " << mSystemBits
-			<< "\nComponentBits: " << mTypeBits << endl << endl;
+			<< "\nComponentBits: " << mSignature.required
+			<< "\nExcludedBits: " << mSignature.excluded
+			<< "\nOptionalBits: " << mSignature.optional
+			<< "\nRuns: " << mStats.runs << ", Overruns: " << mStats.overruns
+			<< ", Dropped Steps: " << mStats.droppedSteps
+			<< ", Last: " << mStats.lastMicroseconds << "us, Max: " << mStats.maxMicroseconds << "us" << endl << endl;
 
 
 
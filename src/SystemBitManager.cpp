@@ -1,19 +1,35 @@
 #include "SystemBitManager.h"
 
+namespace
+{
+	/** Created by the first lookup, from any thread */
+	std::once_flag systemBitMapFlag;
+	Atlas::TypeRegistry<std::bitset<Atlas::BITSIZE>>* systemBitMap = nullptr;
+}
+
 namespace Atlas
 {
 	std::bitset<BITSIZE> SystemBitManager::getBitsFor(const std::type_index& type)
 	{
-		// if the System is not in the map, assign a bit to it and add it to the map
-		if (mSystemBitMap.find(type) == mSystemBitMap.end())
+		// if the System is not in the map, assign the next bit to it
+		return getSystemBitMap().findOrAdd(type, [](std::size_t index)
 		{
-			mSystemBitMap[type] = mNextBit;
-			mNextBit <<= 1;
-		}
+			return std::bitset<BITSIZE>().set(index);
+		});
+	}
 
-		return mSystemBitMap[type];
+	void SystemBitManager::freeze()
+	{
+		getSystemBitMap().freeze();
 	}
 
-	std::bitset<BITSIZE> SystemBitManager::mNextBit(1);
-	std::unordered_map<std::type_index, std::bitset<BITSIZE>> SystemBitManager::mSystemBitMap;
+	bool SystemBitManager::isFrozen()
+	{
+		return getSystemBitMap().isFrozen();
+	}
+
+	TypeRegistry<std::bitset<BITSIZE>>& SystemBitManager::getSystemBitMap()
+	{
+		return TypeRegistry<std::bitset<BITSIZE>>::getShared(systemBitMapFlag, systemBitMap);
+	}
 }
\ No newline at end of file
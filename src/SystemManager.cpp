@@ -1,8 +1,12 @@
 #include "SystemManager.h"
 #include "SystemBitManager.h"
 #include "Utilities.h"
+#include "World.h"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cmath>
 #include <iostream>
 
 namespace Atlas
@@ -13,24 +17,152 @@ namespace Atlas
 	{
 	}
 
+	SystemManager::~SystemManager()
+	{
+		// tasks use their System, so they must complete before it is destroyed
+		waitAll();
+	}
+
 	void SystemManager::addSystem(System::Ptr system)
 	{
 		// Assign system bits
 		system->setSystemBits(SystemBitManager::getBitsFor(system.get()));
 
+		// Systems without Component types are never interested in any Entity
+		if (system->mSignature.required.any())
+			mWorld.getQueryManager().attach(*system);
+
 		mSystems.push_back(std::move(system));
 	}
 
 	void SystemManager::update(float dt)
 	{
+		HierarchyManager& hierarchy = mWorld.getHierarchyManager();
+
 		for (auto& system : mSystems)
-				system->update(dt);
+		{
+			Schedule& schedule = system->mSchedule;
+
+			// an asynchronous System in flight skips the frame, the time is passed to its next update
+			if (schedule.task.valid())
+			{
+				if (schedule.task.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+				{
+					schedule.waited += dt;
+					continue;
+				}
+
+				system->finishTask();
+			}
+
+			const float frameTime = dt + schedule.waited;
+			schedule.waited = 0.0f;
+
+			// restore depth-first order if Entities were added or the hierarchy changed
+			if (system->mIsDepthFirst && system->mQuery != nullptr)
+				system->mQuery->sortDepthFirst(hierarchy);
+
+			switch (schedule.mode)
+			{
+			case Schedule::EVERY_FRAME:
+				run(*system, frameTime);
+				break;
+
+			case Schedule::FIXED_STEP:
+			{
+				schedule.accumulator += frameTime;
+
+				unsigned int steps = 0;
+				while (schedule.accumulator >= schedule.interval && steps < schedule.maxSteps)
+				{
+					run(*system, schedule.interval);
+					schedule.accumulator -= schedule.interval;
+					steps++;
+				}
+
+				// drop the steps the System can not catch up on, instead of falling further behind
+				if (schedule.accumulator >= schedule.interval)
+				{
+					const float dropped = std::floor(schedule.accumulator / schedule.interval);
+					system->mStats.droppedSteps += static_cast<unsigned long long>(dropped);
+					schedule.accumulator -= dropped * schedule.interval;
+				}
+				break;
+			}
+
+			case Schedule::RATE:
+			{
+				for (auto& elapsed : schedule.sliceElapsed)
+					elapsed += frameTime;
+
+				// each slice runs once per interval, so slices run at an even spacing
+				const float spacing = schedule.interval / schedule.slices;
+				schedule.accumulator += frameTime;
+
+				if (schedule.accumulator < spacing)
+					break;
+
+				// at most one update per frame, the remainder is kept for the next slice
+				schedule.accumulator = std::min(schedule.accumulator - spacing, spacing);
+
+				const float elapsed = schedule.sliceElapsed[schedule.slice];
+				schedule.sliceElapsed[schedule.slice] = 0.0f;
+
+				run(*system, elapsed);
+				schedule.slice = (schedule.slice + 1) % schedule.slices;
+				break;
+			}
+			}
+		}
+	}
+
+	void SystemManager::run(System& system, float dt)
+	{
+		typedef std::chrono::steady_clock Clock;
+
+		waitForConflicts(system);
+
+		if (system.mSchedule.isAsync)
+		{
+			system.startTask(dt);
+			return;
+		}
+
+		const Clock::time_point start = Clock::now();
+
+		if (system.mSchedule.isTimeSliced)
+		{
+			const auto slice = std::chrono::duration<double, std::micro>(system.mSchedule.timeSlice);
+			system.mSchedule.start = start;
+			system.mSchedule.deadline = start + std::chrono::duration_cast<Clock::duration>(slice);
+			system.beginPass();
+		}
+
+		system.update(dt);
+		system.recordRun(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+	}
+
+	void SystemManager::waitForConflicts(System& system)
+	{
+		if ((system.mResourceReads | system.mResourceWrites).none())
+			return;
+
+		// the other System is collected here and starts its next update on its own turn
+		for (auto& other : mSystems)
+			if (other.get() != &system && other->mSchedule.task.valid() && system.conflictsWith(*other))
+				other->finishTask();
 	}
 
 	void SystemManager::checkInterest(Entity& e)
+	{
+		ATLAS_PROFILE(mWorld.getProfiler(), Profiler::CHECK_INTEREST, Profiler::NO_TYPE);
+		mWorld.getQueryManager().checkInterest(e);
+	}
+
+	void SystemManager::waitAll()
 	{
 		for (auto& system : mSystems)
-			system->checkInterest(e);
+			system->wait();
 	}
 
 	template <typename Type>
@@ -41,6 +173,11 @@ namespace Atlas
 				system = nullptr;
 	}
 
+	void SystemManager::reportMemory(MemoryReport& report) const
+	{
+		report.systems.reserved += mSystems.capacity() * sizeof(System::Ptr);
+	}
+
 	void SystemManager::toString()
 	{
 		using namespace std;
@@ -1,17 +1,34 @@
 #include "World.h"
+#include "Snapshot.h"
+#include "MappedSnapshot.h"
+#include "SnapshotDelta.h"
 
 namespace Atlas
 {
 	World::World() 
 	: mEntityManager(*this)
+	, mQueryManager(*this)
 	, mSystemManager(*this)
 	, mGroupManager()
+	, mHierarchyManager(*this)
+	, mFieldManager()
+	, mObserverManager(*this)
+	, mResourceManager()
+	, mProfiler()
+	, mDefragmenting(false)
 	{
 	}
 
+	World::~World()
+	{
+		// tasks may read parts of the World that are destroyed before the SystemManager
+		mSystemManager.waitAll();
+	}
+
 	void World::update(float dt)
 	{
 		mEntityManager.update();
+		mObserverManager.dispatch();
 		mSystemManager.update(dt);
 	}
 
@@ -25,6 +42,83 @@ namespace Atlas
 		return mEntityManager.getEntity(id);
 	}
 
+	MemoryReport World::memoryReport() const
+	{
+		MemoryReport report;
+
+		mEntityManager.reportMemory(report);
+		mQueryManager.reportMemory(report);
+		mSystemManager.reportMemory(report);
+		mGroupManager.reportMemory(report);
+		mHierarchyManager.reportMemory(report);
+		mFieldManager.reportMemory(report);
+
+		return report;
+	}
+
+	ProfileReport World::profileReport()
+	{
+		return mProfiler.report();
+	}
+
+	void World::shrinkToFit()
+	{
+		mEntityManager.shrinkToFit();
+		mQueryManager.shrinkToFit();
+		mGroupManager.shrinkToFit();
+		mHierarchyManager.shrinkToFit();
+	}
+
+	std::vector<Entity::Relocation> World::defragment(unsigned int maxMoves)
+	{
+		// asynchronous updates hold Entity lists that are about to change
+		mSystemManager.waitAll();
+
+		std::vector<Entity::Relocation> relocations = mEntityManager.defragment(maxMoves);
+
+		// once a pass is complete, restore front to back iteration order for Systems
+		if (relocations.empty() && mDefragmenting)
+			mQueryManager.sortEntities();
+
+		mDefragmenting = !relocations.empty();
+
+		return relocations;
+	}
+
+	std::vector<char> World::saveSnapshot()
+	{
+		return Snapshot::save(*this);
+	}
+
+	bool World::loadSnapshot(const std::vector<char>& data)
+	{
+		mSystemManager.waitAll();
+		return Snapshot::load(*this, data.data(), data.size());
+	}
+
+	bool World::loadSnapshot(const MappedSnapshot& snapshot)
+	{
+		mSystemManager.waitAll();
+		// the file was parsed when it was mapped
+		return snapshot.isOpen() && Snapshot::load(*this, snapshot.getContents());
+	}
+
+	bool World::applyDelta(const std::vector<char>& delta)
+	{
+		mSystemManager.waitAll();
+		return SnapshotDelta::apply(*this, delta.data(), delta.size());
+	}
+
+	void World::clone(World& target, bool copyOnWrite)
+	{
+		mSystemManager.waitAll();
+		target.mSystemManager.waitAll();
+
+		mEntityManager.cloneTo(target.mEntityManager, copyOnWrite);
+		mResourceManager.cloneTo(target.mResourceManager);
+		target.mDefragmenting = mDefragmenting;
+	}
+
 	EntityManager& World::getEntityManager()
 	{
 		return mEntityManager;
@@ -39,4 +133,34 @@ namespace Atlas
 	{
 		return mGroupManager;
 	}
+
+	HierarchyManager& World::getHierarchyManager()
+	{
+		return mHierarchyManager;
+	}
+
+	QueryManager& World::getQueryManager()
+	{
+		return mQueryManager;
+	}
+
+	FieldManager& World::getFieldManager()
+	{
+		return mFieldManager;
+	}
+
+	ObserverManager& World::getObserverManager()
+	{
+		return mObserverManager;
+	}
+
+	ResourceManager& World::getResourceManager()
+	{
+		return mResourceManager;
+	}
+
+	Profiler& World::getProfiler()
+	{
+		return mProfiler;
+	}
 }
\ No newline at end of file